@@ -23,6 +23,7 @@
 #include "Stripe.h"
 #include "ExtentItem.h"
 #include "BlockGroupItem.h"
+#include "UuidItem.h"
 
 #include "UnknownItem.h"
 
@@ -15,7 +15,7 @@ namespace btrForensics{
     //! \param endian The endianess of the array.
     //! \param arr Byte array storing block group item data.
     //!
-    BlockGroupItem::BlockGroupItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
+    BlockGroupItem::BlockGroupItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
         :BtrfsItem(head)
     {
         int arIndex(0); //Key initialized already.
@@ -20,7 +20,7 @@ namespace btrForensics {
         uint64_t flags;
 
     public:
-        BlockGroupItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
+        BlockGroupItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
         ~BlockGroupItem() = default;
 
         std::string dataInfo() const override;
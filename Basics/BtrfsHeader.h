@@ -39,6 +39,8 @@ namespace btrForensics{
 
         //! Return true if the header indicates it is a leaf node.
         const bool isLeafNode() const { return level == 0; }
+        //! Return level of the node in its tree, 0 for a leaf.
+        uint8_t getLevel() const { return level; }
         
         friend std::ostream &operator<<(
             std::ostream &os, const BtrfsHeader &header);
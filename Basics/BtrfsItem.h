@@ -15,11 +15,11 @@ namespace btrForensics{
     //! Btrfs item in a leaf node, this is an abstract class.
     class BtrfsItem {
     public:
-        const ItemHead* itemHead ; //!< Item stored in leaf node.
+        const ItemHead* itemHead ; //!< Item head, owned by the leaf node.
         
         //! Constructor of item
-        BtrfsItem(ItemHead* head):itemHead(head) {}
-        virtual ~BtrfsItem() { delete itemHead; }
+        BtrfsItem(const ItemHead* head):itemHead(head) {}
+        virtual ~BtrfsItem() = default; //!< Destructor
 
         //! Get id of the item.
         const uint64_t getId() const { return itemHead->key.objId; }
@@ -97,15 +97,32 @@ namespace btrForensics{
             case 0xe4:
                 itemType = ItemType::CHUNK_ITEM;
                 break;
+            case 0xfb:
+                itemType = ItemType::UUID_SUBVOL;
+                break;
+            case 0xfc:
+                itemType = ItemType::UUID_RECEIVED_SUBVOL;
+                break;
             case 0xfd:
                 itemType = ItemType::STRING_ITEM;
                 break;
             default:
-                itemType = ItemType::UNKNOWN;
+                //Keep the on-disk value, so that keys still sort in disk order.
+                itemType = static_cast<ItemType>(type);
         }
     }
 
 
+    //! Constructor of key from its fields.
+    //!
+    //! \param id Object id.
+    //! \param type Item type.
+    //! \param off Offset.
+    //!
+    BtrfsKey::BtrfsKey(uint64_t id, ItemType type, uint64_t off)
+        :objId(id), itemType(type), offset(off) {}
+
+
 
     //! Overloaded stream operator.
     std::ostream &operator<<(std::ostream &os, const BtrfsKey &key)
@@ -115,6 +132,7 @@ namespace btrForensics{
         os << " (0x" << key.objId << ")\n";
         os << "Key - Item type: " << key.getItemTypeStr() << '\n';
         os << "Key - Offset: 0x" << key.offset << '\n';
+        return os;
     }
 
 
@@ -198,6 +216,12 @@ namespace btrForensics{
             case ItemType::CHUNK_ITEM:
                 type = "chunk item";
                 break;
+            case ItemType::UUID_SUBVOL:
+                type = "uuid subvol";
+                break;
+            case ItemType::UUID_RECEIVED_SUBVOL:
+                type = "uuid received subvol";
+                break;
             case ItemType::STRING_ITEM:
                 type = "string item";
                 break;
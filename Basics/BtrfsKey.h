@@ -22,11 +22,29 @@ namespace btrForensics{
         //Total bytes: 0x11
     public:
         BtrfsKey(TSK_ENDIAN_ENUM endian, uint8_t arr[]);
+        BtrfsKey(uint64_t id, ItemType type, uint64_t off);
         ~BtrfsKey() = default; //!< Destructor
 
         friend std::ostream &operator<<(
             std::ostream &os, const BtrfsKey &key);
 
+        //! Compare keys by object id, item type and offset, the order of btrfs trees.
+        friend bool operator<(const BtrfsKey &lhs, const BtrfsKey &rhs)
+        {
+            if(lhs.objId != rhs.objId)
+                return lhs.objId < rhs.objId;
+            if(lhs.itemType != rhs.itemType)
+                return lhs.itemType < rhs.itemType;
+            return lhs.offset < rhs.offset;
+        }
+
+        //! Check if all fields of two keys are equal.
+        friend bool operator==(const BtrfsKey &lhs, const BtrfsKey &rhs)
+        {
+            return lhs.objId == rhs.objId && lhs.itemType == rhs.itemType
+                && lhs.offset == rhs.offset;
+        }
+
         //const uint8_t getItemType() const;
         const std::string getItemTypeStr() const;
 
@@ -43,7 +43,7 @@ namespace btrForensics{
         //! Get offset
         //uint64_t getOffset() const { return offset; }
         
-        //static const int SIZE_OF_CHUNK_DATA= 0x30; //!< Size of chunk item data in bytes.
+        static const int SIZE_OF_CHUNK_DATA = 0x30; //!< Size of chunk item data in bytes, stripes excluded.
     };
 }
 
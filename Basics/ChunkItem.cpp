@@ -15,7 +15,7 @@ namespace btrForensics{
     //! \param endian The endianess of the array.
     //! \param arr Byte array storing chunk item data.
     //!
-    ChunkItem::ChunkItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
+    ChunkItem::ChunkItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
         :BtrfsItem(head), data(endian, arr)
     {
     }
@@ -19,7 +19,7 @@ namespace btrForensics{
         ChunkData data; //!< Data part of chunk item.
 
     public:
-        ChunkItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
+        ChunkItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
         ~ChunkItem() = default; //!< Destructor
 
         std::string dataInfo() const override;
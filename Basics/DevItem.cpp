@@ -15,7 +15,7 @@ namespace btrForensics{
     //! \param endian The endianess of the array.
     //! \param arr Byte array storing inode data.
     //!
-    DevItem::DevItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
+    DevItem::DevItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
         :BtrfsItem(head), data(endian, arr)
     {
     }
@@ -19,7 +19,7 @@ namespace btrForensics{
         DevData data;
 
     public:
-        DevItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
+        DevItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
         ~DevItem() = default; //!< Destructor
 
         std::string dataInfo() const override;
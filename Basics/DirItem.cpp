@@ -9,14 +9,26 @@
 
 namespace btrForensics{
 
+    //! Check that item data holds the fixed part of a dir item.
+    //!
+    //! \return The data array.
+    //!
+    static uint8_t* checkHeader(const ItemHead* head, uint8_t arr[])
+    {
+        if(head->getDataSize() < DirItem::SIZE_OF_HEADER)
+            throw FsDamagedException("Dir item is smaller than its header.");
+        return arr;
+    }
+
+
     //! Constructor of dir item.
     //!
     //! \param head Item head points to this data.
     //! \param endian The endianess of the array.
     //! \param arr Byte array storing dir item data.
     //!
-    DirItem::DirItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
-        :BtrfsItem(head), targetKey(endian, arr)
+    DirItem::DirItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
+        :BtrfsItem(head), targetKey(endian, checkHeader(head, arr))
     {
         int arIndex(BtrfsKey::SIZE_OF_KEY); //Key initialized already.
         transId = read64Bit(endian, arr + arIndex);
@@ -29,10 +41,10 @@ namespace btrForensics{
         
         childType = arr[arIndex++];
 
-        dirName = new char[nameSize]();
-        for(int i=0; i < nameSize; ++i){
-            dirName[i] = arr[arIndex++];
-        }
+        if((uint32_t)nameSize + dataSize > head->getDataSize() - SIZE_OF_HEADER)
+            throw FsDamagedException("Dir item name exceeds item size.");
+        //Name is not copied, the leaf node owning this item keeps the bytes.
+        dirName = reinterpret_cast<const char*>(arr + arIndex);
 
         switch(childType) {
             case 0:
@@ -68,14 +80,6 @@ namespace btrForensics{
     }
 
 
-    //!< Destructor
-    DirItem::~DirItem()
-    {
-        if(dirName != nullptr)
-            delete [] dirName;
-    }
-
-
     //! Return name of the directory.
     std::string DirItem::getDirName() const
     {
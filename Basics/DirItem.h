@@ -22,22 +22,22 @@ namespace btrForensics {
         uint16_t dataSize;
         uint16_t nameSize;
         uint8_t childType;
-        char *dirName;
-        char *dirData;
+        const char *dirName; //!< Points into the data of the leaf node.
 
     public:
-        DirItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
-        ~DirItem();
+        DirItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
 
         //! Get inode number of target this item points to.
-        uint64_t getTargetInode() { return targetKey.objId; }  
+        uint64_t getTargetInode() const { return targetKey.objId; }  
 
         //! Get item type of target this item points to.
-        ItemType getTargetType() { return targetKey.itemType; }  
+        ItemType getTargetType() const { return targetKey.itemType; }  
 
         std::string getDirName() const;
 
         std::string dataInfo() const override;
+
+        static const uint32_t SIZE_OF_HEADER = 0x1e; //!< Size of dir item data before the name.
     };
 }
 
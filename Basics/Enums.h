@@ -35,6 +35,8 @@ namespace btrForensics {
         DEV_EXTENT = 0xcc,
         DEV_ITEM = 0xd8,
         CHUNK_ITEM = 0xe4,
+        UUID_SUBVOL = 0xfb,
+        UUID_RECEIVED_SUBVOL = 0xfc,
         STRING_ITEM = 0xfd,
         UNKNOWN = 0xff
     };
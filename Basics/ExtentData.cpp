@@ -14,7 +14,7 @@ namespace btrForensics {
     //! \param arr Byte array storing extent data.
     //! \param address Physical address of current Btrfs item data part.
     //!
-    ExtentData::ExtentData(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[], uint64_t address)
+    ExtentData::ExtentData(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[], uint64_t address)
         :BtrfsItem(head)
     {
         int arIndex(0);
@@ -29,7 +29,7 @@ namespace btrForensics {
         uint64_t numOfBytes; //!< Logical number of bytes in extent for non-inline file.
 
     public:
-        ExtentData(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[], uint64_t address);
+        ExtentData(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[], uint64_t address);
         ~ExtentData() = default; //!< Destructor
 
         std::string dataInfo() const override;
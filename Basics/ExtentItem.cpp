@@ -15,7 +15,7 @@ namespace btrForensics{
     //! \param endian The endianess of the array.
     //! \param arr Byte array storing extent item data.
     //!
-    ExtentItem::ExtentItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
+    ExtentItem::ExtentItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
         :BtrfsItem(head), key(endian, arr+0x18)
     {
         int arIndex(0); //Key initialized already.
@@ -22,7 +22,7 @@ namespace btrForensics {
         uint8_t level;
 
     public:
-        ExtentItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
+        ExtentItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
         ~ExtentItem() = default;
 
         std::string dataInfo() const override;
@@ -6,6 +6,7 @@
 #include <sstream>
 #include "InodeData.h"
 #include "Utility/ReadInt.h"
+#include "Utility/StringProcess.h"
 
 namespace btrForensics{
 
@@ -73,9 +74,9 @@ namespace btrForensics{
     {
         std::ostringstream oss;
         oss << "Size: " << std::dec << humanSize(stSize) << "\n";
-        oss << "Created time:  " << std::asctime(std::localtime(&createdTime));
-        oss << "Access time:   " << std::asctime(std::localtime(&accessTime));
-        oss << "Modified time: " << std::asctime(std::localtime(&modifiedTime));
+        oss << "Created time:  " << timeStr(createdTime);
+        oss << "Access time:   " << timeStr(accessTime);
+        oss << "Modified time: " << timeStr(modifiedTime);
         return oss.str();
     }
 
@@ -6,6 +6,7 @@
 #include <sstream>
 #include "InodeItem.h"
 #include "Utility/ReadInt.h"
+#include "Utility/StringProcess.h"
 
 namespace btrForensics{
 
@@ -15,7 +16,7 @@ namespace btrForensics{
     //! \param endian The endianess of the array.
     //! \param arr Byte array storing inode data.
     //!
-    InodeItem::InodeItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
+    InodeItem::InodeItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
         :BtrfsItem(head), data(endian, arr)
     {
     }
@@ -25,9 +26,9 @@ namespace btrForensics{
     std::string InodeItem::printTime() const
     {
         std::stringstream oss;
-        oss << "Created time:  " << std::asctime(std::localtime(&data.createdTime));
-        oss << "Access time:   " << std::asctime(std::localtime(&data.accessTime));
-        oss << "Modified time: " << std::asctime(std::localtime(&data.modifiedTime));
+        oss << "Created time:  " << timeStr(data.createdTime);
+        oss << "Access time:   " << timeStr(data.accessTime);
+        oss << "Modified time: " << timeStr(data.modifiedTime);
         return oss.str();
     }
     
@@ -19,7 +19,7 @@ namespace btrForensics{
         InodeData data;
 
     public:
-        InodeItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
+        InodeItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
         ~InodeItem() = default; //!< Destructor
 
         std::string printTime() const;
@@ -6,6 +6,7 @@
 #include <sstream>
 #include "InodeRef.h"
 #include "Utility/ReadInt.h"
+#include "Exceptions.h"
 
 namespace btrForensics{
 
@@ -15,28 +16,23 @@ namespace btrForensics{
     //! \param endian The endianess of the array.
     //! \param arr Byte array storing inode ref data.
     //!
-    InodeRef::InodeRef(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
+    InodeRef::InodeRef(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
         :BtrfsItem(head)
     {
+        if(head->getDataSize() < SIZE_OF_HEADER)
+            throw FsDamagedException("Inode ref is smaller than its header.");
+
         int arIndex(0);
         indexInDir = read64Bit(endian, arr + arIndex);
         arIndex += 0x08;
 
         nameSize = read16Bit(endian, arr + arIndex);
         arIndex += 0x02;
-        
-        nameInDir = new char[nameSize]();
-        for(int i=0; i < nameSize; ++i){
-            nameInDir[i] = arr[arIndex++];
-        }
-    }
 
-
-    //!< Destructor
-    InodeRef::~InodeRef()
-    {
-        if(nameInDir != nullptr)
-            delete [] nameInDir;
+        if(nameSize > head->getDataSize() - SIZE_OF_HEADER)
+            throw FsDamagedException("Inode ref name exceeds item size.");
+        //Name is not copied, the leaf node owning this item keeps the bytes.
+        nameInDir = reinterpret_cast<const char*>(arr + arIndex);
     }
 
 
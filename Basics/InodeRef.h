@@ -17,15 +17,16 @@ namespace btrForensics{
     private:
         uint64_t indexInDir;
         uint16_t nameSize;
-        char *nameInDir;
+        const char *nameInDir; //!< Points into the data of the leaf node.
 
     public:
-        InodeRef(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
-        ~InodeRef();
+        InodeRef(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
 
         std::string getDirName() const;
 
         std::string dataInfo() const override;
+
+        static const uint32_t SIZE_OF_HEADER = 0x0a; //!< Size of inode ref data before the name.
     };
 }
 
@@ -5,7 +5,6 @@
 
 #include "KeyPtr.h"
 #include "Utility/ReadInt.h"
-#include "Trees/BtrfsNode.h"
 
 namespace btrForensics{
 
@@ -15,7 +14,7 @@ namespace btrForensics{
     //! \param arr Byte array storing key pointer data.
     //!
     KeyPtr::KeyPtr(TSK_ENDIAN_ENUM endian, uint8_t arr[])
-        :key(endian, arr), childNode(nullptr)
+        :key(endian, arr)
     {
         int arIndex(BtrfsKey::SIZE_OF_KEY); //Key initialized already.
         blkNum = read64Bit(endian, arr + arIndex);
@@ -26,14 +25,6 @@ namespace btrForensics{
     }
 
 
-    //!< Destructor
-    KeyPtr::~KeyPtr()
-    {
-        if(childNode != nullptr)
-            delete childNode;
-    }
-
-
     //! Overloaded stream operator.
     std::ostream &operator<<(std::ostream &os, const KeyPtr &keyPtr)
     {
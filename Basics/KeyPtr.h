@@ -10,16 +10,12 @@
 #include <string>
 #include <tsk/libtsk.h>
 #include "BtrfsKey.h"
-//#include "Trees/BtrfsNode.h"
 
 namespace btrForensics{
-    class BtrfsNode;
-
     //! Key pointers stored in internal nodes, stored right after node header.
     class KeyPtr{
     public:
         const BtrfsKey key; //!< Key of the key pointer.
-        const BtrfsNode* childNode; //!< Pointer to the child node pointed by this key pointer.
     private:
         uint64_t blkNum;
         uint64_t generation;
@@ -28,7 +24,7 @@ namespace btrForensics{
 
     public:
         KeyPtr(TSK_ENDIAN_ENUM endian, uint8_t arr[]);
-        ~KeyPtr();
+        ~KeyPtr() = default; //!< Destructor
 
         const uint64_t getBlkNum() const { return blkNum; }  //!< Return block number.
         const uint32_t getGeneration() const { return generation; }  //!< Return generation.
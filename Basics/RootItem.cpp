@@ -15,7 +15,7 @@ namespace btrForensics{
     //! \param endian The endianess of the array.
     //! \param arr Byte array storing root item data.
     //!
-    RootItem::RootItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
+    RootItem::RootItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
         :BtrfsItem(head), inode(endian, arr), dropProgress(endian, arr + 0xdc)
     {
         int arIndex(InodeData::SIZE_OF_INODE_DATA);
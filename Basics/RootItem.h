@@ -36,7 +36,7 @@ namespace btrForensics{
         uint8_t rootLevel;
 
     public:
-        RootItem(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
+        RootItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
         ~RootItem() = default; //!< Destructor
 
         const uint64_t getRootObjId() const { return rootObjId; } //!< Get id of root directory
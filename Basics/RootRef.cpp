@@ -15,9 +15,12 @@ namespace btrForensics{
     //! \param endian The endianess of the array.
     //! \param arr Byte array storing root ref item data.
     //!
-    RootRef::RootRef(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
+    RootRef::RootRef(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
         :BtrfsItem(head)
     {
+        if(head->getDataSize() < SIZE_OF_HEADER)
+            throw FsDamagedException("Root ref is smaller than its header.");
+
         int arIndex(0); //Key initialized already.
         dirId = read64Bit(endian, arr + arIndex);
         arIndex += 0x08;
@@ -27,19 +30,11 @@ namespace btrForensics{
 
         nameSize = read16Bit(endian, arr + arIndex);
         arIndex += 0x02;
-        
-        dirName = new char[nameSize]();
-        for(int i=0; i < nameSize; ++i){
-            dirName[i] = arr[arIndex++];
-        }
-    }
 
-
-    //!< Destructor
-    RootRef::~RootRef()
-    {
-        if(dirName != nullptr)
-            delete [] dirName;
+        if(nameSize > head->getDataSize() - SIZE_OF_HEADER)
+            throw FsDamagedException("Root ref name exceeds item size.");
+        //Name is not copied, the leaf node owning this item keeps the bytes.
+        dirName = reinterpret_cast<const char*>(arr + arIndex);
     }
 
 
@@ -19,11 +19,12 @@ namespace btrForensics {
         uint64_t dirId;
         uint64_t index;
         uint16_t nameSize;
-        char *dirName;
+        const char *dirName; //!< Points into the data of the leaf node.
 
     public:
-        RootRef(ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
-        ~RootRef();
+        RootRef(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
+
+        static const uint32_t SIZE_OF_HEADER = 0x12; //!< Size of root ref data before the name.
 
         //! Get directory id that contains the subtree.
         uint64_t getDirId() { return dirId; }  
@@ -31,6 +32,11 @@ namespace btrForensics {
         //! Get index number.
         uint64_t getIndex() { return index; }  
 
+        //! Get id of the subvolume, which is in the key offset of a root ref
+        //! and in the key object id of a root backref.
+        uint64_t getSubvolId() const {
+            return getItemType() == ItemType::ROOT_REF ? itemHead->key.offset : itemHead->key.objId; }
+
         std::string getDirName() const;
 
         std::string dataInfo() const override;
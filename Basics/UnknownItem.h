@@ -16,7 +16,7 @@ namespace btrForensics{
     class UnknownItem : public BtrfsItem {
     public:
         //! Constructor of unknown item.
-        UnknownItem(ItemHead* head):BtrfsItem(head) {}
+        UnknownItem(const ItemHead* head):BtrfsItem(head) {}
         ~UnknownItem() = default; //!< Destructor
 
         //! Infomation unavailable yet.
@@ -0,0 +1,43 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class UuidItem
+
+#include <sstream>
+#include "UuidItem.h"
+#include "Utility/ReadInt.h"
+
+namespace btrForensics{
+
+    //! Constructor of uuid item.
+    //!
+    //! \param head Item head points to this data.
+    //! \param endian The endianess of the array.
+    //! \param arr Byte array storing subvolume ids.
+    //!
+    UuidItem::UuidItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[])
+        :BtrfsItem(head), endian(endian), idArr(arr)
+    {
+    }
+
+
+    //! Get a subvolume id.
+    //!
+    //! \param index Index of the id, less than getNumOfIds().
+    //!
+    uint64_t UuidItem::getSubvolId(uint32_t index) const
+    {
+        return read64Bit(endian, idArr + index * 8);
+    }
+
+
+    //! Return infomation about the item data as string.
+    std::string UuidItem::dataInfo() const
+    {
+        std::ostringstream oss;
+        oss << "Subvolume ids:";
+        for(uint32_t i = 0; i < getNumOfIds(); ++i)
+            oss << ' ' << getSubvolId(i);
+        return oss.str();
+    }
+}
@@ -0,0 +1,35 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class UuidItem
+
+#ifndef UUID_ITEM_H
+#define UUID_ITEM_H
+
+#include <iostream>
+#include <string>
+#include <tsk/libtsk.h>
+#include "BtrfsItem.h"
+
+namespace btrForensics{
+    //! Item of the UUID tree, listing subvolumes with a UUID.
+    //!
+    //! The UUID is stored in the key, the data is an array of subvolume ids.
+    class UuidItem : public BtrfsItem {
+    private:
+        TSK_ENDIAN_ENUM endian;
+        const uint8_t *idArr; //!< Points into the data of the leaf node.
+
+    public:
+        UuidItem(const ItemHead* head, TSK_ENDIAN_ENUM endian, uint8_t arr[]);
+
+        //! Get number of subvolume ids.
+        uint32_t getNumOfIds() const { return itemHead->getDataSize() / 8; }
+
+        uint64_t getSubvolId(uint32_t index) const;
+
+        std::string dataInfo() const override;
+    };
+}
+
+#endif
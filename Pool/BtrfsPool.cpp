@@ -4,6 +4,7 @@
 //! Implementation of class BtrfsPool.
 
 #include <map>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 #include "BtrfsPool.h"
@@ -22,13 +23,25 @@ namespace btrForensics {
 //!
 BtrfsPool::BtrfsPool(TSK_IMG_INFO *img, TSK_ENDIAN_ENUM end,
         vector<TSK_OFF_T> devOffsets, uint64_t fsRootId)
-    :image(img), endian(end)
+    :image(img), imgSource(ImageSource::open(img)),
+     readEngine(new ReadEngine(imgSource)), endian(end), primarySupblk(nullptr),
+     chunkTree(nullptr), fsTree(nullptr), fsTreeDefault(nullptr), pathResolver(this),
+     prefetchBudget(DEFAULT_PREFETCH_BUDGET),
+     threadCount(std::max(1u, std::thread::hardware_concurrency()))
 {
+    imgSource->setMaxReaders(threadCount + 1);
     uint64_t devCount(0);
     for(auto dev_off : devOffsets) {
         char *diskArr = new char[SuperBlock::SUPBLK_SIZE]();
-        tsk_img_read(img, dev_off + SuperBlock::SUPBLK_ADDR, diskArr, SuperBlock::SUPBLK_SIZE);
-        SuperBlock *supblk = new SuperBlock(TSK_LIT_ENDIAN, (uint8_t*)diskArr);
+        imgSource->read(dev_off + SuperBlock::SUPBLK_ADDR, diskArr, SuperBlock::SUPBLK_SIZE);
+        SuperBlock *supblk(nullptr);
+        try {
+            supblk = new SuperBlock(TSK_LIT_ENDIAN, (uint8_t*)diskArr);
+        } catch(...) {
+            delete [] diskArr;
+            throw;
+        }
+        delete [] diskArr;
 
         if(fsUUID.isUnused()) {
             fsUUID = supblk->fsUUID;
@@ -69,12 +82,21 @@ BtrfsPool::BtrfsPool(TSK_IMG_INFO *img, TSK_ENDIAN_ENUM end,
 //! Destructor
 BtrfsPool::~BtrfsPool()
 {
+    if(fsTree != nullptr && fsTree != fsTreeDefault)
+        delete fsTree;
+    if(fsTreeDefault != nullptr)
+        delete fsTreeDefault;
+    if(chunkTree != nullptr)
+        delete chunkTree;
     if(primarySupblk != nullptr)
         delete primarySupblk;
     for(auto &record : deviceTable) {
         delete record.second;
         record.second = nullptr;
     }
+    std::atomic_store(&prefetcher, std::shared_ptr<NodePrefetcher>());
+    delete readEngine;
+    delete imgSource;
 }
 
 
@@ -109,86 +131,380 @@ uint64_t BtrfsPool::getDevOffset(uint64_t devId) const
 }
 
 
-//! Get the physical addresses from a chunk item.
+//! Add a chunk to the chunk map of the pool.
 //!
-//! \param logicalAddr Logical address to convert.
-//! \param key Key storing chunk logical address.
-//! \param chunkData Chunk item data storing corresponding physical address.
+//! \param logicalAddr Logical address of the chunk, stored in key offset.
+//! \param chunkData Chunk item data storing stripes of the chunk.
 //!
-//! \return Mapped physical address. 0 if not valid.
+//! \return False if the chunk is mapped already.
 //!
-vector<uint64_t> BtrfsPool::getAddrFromChunk(uint64_t logicalAddr,
-        const BtrfsKey* key, const ChunkData* chunkData) const
+bool BtrfsPool::mapChunk(uint64_t logicalAddr, const ChunkData* chunkData)
 {
-    vector<uint64_t> physicalAddrs;
-    uint64_t chunkLogical = key->offset; //Key offset stores logical address.
-
-    //Input logical address should be larger than chunk logial address.
-    if(logicalAddr < chunkLogical)
-        throw FsDamagedException("Superblock chunk item error."
-                "Unable to map logical address to physical address.");
-
-    //There should be at least one stripe within the chunk data.
-    if(chunkData->numStripe == 0)
-        throw FsDamagedException("Superblock chunk item error. No stripe found.");
-    else if(chunkData->numStripe > 1)
-        throw FsDamagedException("Test only: This chunk has more than 1 stripes!");
-
+    ChunkRange range;
+    range.logicalAddr = logicalAddr;
+    range.size = chunkData->chunkSize;
+    range.stripeLength = chunkData->stripeLength;
+    range.type = chunkData->type;
+    range.subStripe = chunkData->subStripe;
+
+    vector<ChunkStripe> stripes;
     for(const auto &stripe : chunkData->btrStripes) {
-        //Get device offset from stripe device ID
-        uint64_t deviceOffset = getDevOffset(stripe->deviceId);
-        //Data offset stores relative physical address.
-        uint64_t chunkPhysical = deviceOffset + stripe->offset; 
-    
-        physicalAddrs.push_back(logicalAddr - chunkLogical + chunkPhysical);
+        //Stripe offset is relative to the device.
+        ChunkStripe chunkStripe;
+        chunkStripe.deviceId = stripe->deviceId;
+        chunkStripe.physicalAddr = getDevOffset(stripe->deviceId) + stripe->offset;
+        stripes.push_back(chunkStripe);
     }
 
-    return physicalAddrs;
+    return chunkMap.insert(range, stripes);
 }
 
 
-//! Read data from image based on given logical address and chunk.
+//! Read data from image based on given logical address.
+//!
+//! Reads spanning several stripes are split at stripe boundaries.
 //!
 //! \param[out] data Array with data read from image
 //! \param logicalAddr Logical address of data.
-//! \param key Btrfs chunk item key.
-//! \param chunkData Btrfs chunk item data.
 //! \param size Size of data.
 //!
 //! \return Starting physcial address of data in the image.
 //! 
-uint64_t BtrfsPool::readChunkData(char *data, uint64_t logicalAddr,
-        const BtrfsKey* key, const ChunkData* chunkData, const uint64_t size) const
+uint64_t BtrfsPool::readData(char *data, uint64_t logicalAddr,
+                            const uint64_t size) const
 {
-    vector<uint64_t> physicalAddrs = getAddrFromChunk(logicalAddr, key, chunkData);
-
+    uint64_t startAddr(0);
     uint64_t readSize(0);
-    uint64_t length = chunkData->stripeLength;
-    for(const auto &addr: physicalAddrs) {
-        while(size - readSize > length) {
-            tsk_img_read(image, addr + readSize, data + readSize, length);
+    while(readSize < size) {
+        uint64_t physicalAddr, length;
+        if(!chunkMap.mapAddress(logicalAddr + readSize, physicalAddr, length)) {
+            ostringstream oss;
+            oss << "Unable to map logical address 0x" << hex
+                << logicalAddr + readSize << " to physical address.";
+            throw FsDamagedException(oss.str());
+        }
+        if(readSize == 0)
+            startAddr = physicalAddr;
+
+        length = min(length, size - readSize);
+        imgSource->read(physicalAddr, data + readSize, length);
+        readSize += length;
+    }
+
+    return startAddr;
+}
+
+
+//! Translate logical reads to physical reads, split at stripe boundaries.
+//!
+//! Reads adjacent both in the image and in memory are merged.
+//!
+//! \param requests Reads with logical addresses as offsets.
+//!
+//! \return Reads with physical addresses as offsets.
+//!
+vector<ReadRequest> BtrfsPool::mapRequests(const vector<ReadRequest> &requests) const
+{
+    vector<ReadRequest> physicalRequests;
+    for(const auto &req : requests) {
+        uint64_t readSize(0);
+        while(readSize < req.size) {
+            uint64_t physicalAddr, length;
+            if(!chunkMap.mapAddress(req.offset + readSize, physicalAddr, length)) {
+                ostringstream oss;
+                oss << "Unable to map logical address 0x" << hex
+                    << req.offset + readSize << " to physical address.";
+                throw FsDamagedException(oss.str());
+            }
+            length = min(length, req.size - readSize);
+
+            //Merge with previous read if adjacent both in image and in memory.
+            if(!physicalRequests.empty()) {
+                ReadRequest &last = physicalRequests.back();
+                if(last.offset + last.size == physicalAddr
+                        && last.data + last.size == req.data + readSize) {
+                    last.size += length;
+                    readSize += length;
+                    continue;
+                }
+            }
+            physicalRequests.push_back(ReadRequest{physicalAddr, req.data + readSize, length});
             readSize += length;
         }
-        tsk_img_read(image, addr + readSize, data + readSize, size - readSize);
     }
+    return physicalRequests;
+}
+
 
-    return physicalAddrs[0];
+//! Read a batch of data from image, with the reads in flight at once.
+//!
+//! \param requests Reads to perform, offsets are logical addresses.
+//!
+void BtrfsPool::readDataBatch(const vector<ReadRequest> &requests) const
+{
+    //The ring of the engine has a single submitter.
+    std::lock_guard<std::mutex> guard(engineLock);
+    readEngine->read(mapRequests(requests));
 }
 
 
-//! Read data from image based on given logical address.
+//! Set maximum number of image reads in flight.
+//!
+//! Walks running on other threads keep the prefetcher they hold,
+//! the new depth applies to the prefetcher created next.
+//!
+void BtrfsPool::setQueueDepth(unsigned depth)
+{
+    {
+        std::lock_guard<std::mutex> guard(engineLock);
+        readEngine->setQueueDepth(depth);
+    }
+    //Recreated with the new depth when needed.
+    std::atomic_store(&prefetcher, std::shared_ptr<NodePrefetcher>());
+}
+
+
+//! Set bytes of nodes read ahead during tree walks.
+//!
+//! \param budget Budget in bytes, 0 disables prefetching.
+//!
+void BtrfsPool::setPrefetchBudget(uint64_t budget)
+{
+    prefetchBudget = budget;
+    std::atomic_store(&prefetcher, std::shared_ptr<NodePrefetcher>());
+}
+
+
+//! Read nodes in background before a tree walk reaches them.
+//!
+//! \param node Internal node being walked.
+//! \param first Index of the first child to prefetch.
+//! \param count Number of children to prefetch, fewer if the node ends before.
+//!
+void BtrfsPool::prefetchChildren(const InternalNode *node, size_t first, size_t count) const
+{
+    const auto &vecPtr = node->keyPointers;
+    if(first >= vecPtr.size())
+        return;
+    std::shared_ptr<NodePrefetcher> current = startPrefetcher();
+    if(current == nullptr)
+        return;
+
+    vector<uint64_t> addrs;
+    size_t end = std::min(vecPtr.size(), first + count);
+    for(size_t i=first; i<end; ++i)
+        addrs.push_back(vecPtr[i]->getBlkNum());
+    current->request(addrs);
+}
+
+
+//! Create the prefetcher if prefetching is enabled and it does not exist yet.
+//!
+//! \return The prefetcher, empty if prefetching is disabled. It stays
+//! valid while held, even if the setters replace it meanwhile.
+//!
+std::shared_ptr<NodePrefetcher> BtrfsPool::startPrefetcher() const
+{
+    uint64_t budget = prefetchBudget;
+    //Chunk map is still being filled while chunk tree is walked.
+    if(chunkTree == nullptr || budget < primarySupblk->nodeSize)
+        return nullptr;
+    std::shared_ptr<NodePrefetcher> current = std::atomic_load(&prefetcher);
+    if(current != nullptr)
+        return current;
+
+    std::lock_guard<std::mutex> guard(prefetcherLock);
+    current = std::atomic_load(&prefetcher);
+    if(current == nullptr) {
+        current = std::make_shared<NodePrefetcher>(this, budget, getQueueDepth());
+        std::atomic_store(&prefetcher, current);
+    }
+    return current;
+}
+
+
+//! Set number of threads of parallel tree walks.
+//!
+//! \param threads Number of threads, 0 is taken as 1, at most MAX_THREADS are used.
+//!
+void BtrfsPool::setThreads(unsigned threads)
+{
+    threadCount = threads == 0 ? 1 : std::min(threads, unsigned(MAX_THREADS));
+    //Walkers and the prefetcher read the image at the same time.
+    imgSource->setMaxReaders(threadCount + 1);
+}
+
+
+//! Split the tree under a node into subtrees at key pointers.
+//!
+//! Levels are expanded from the top until there are at least minParts
+//! subtrees or only leaves are left.
+//!
+//! \param node Node being split.
+//! \param minParts Number of subtrees wanted.
+//!
+//! \return Roots of the subtrees, in key order.
+//!
+vector<NodePtr> BtrfsPool::splitTree(const BtrfsNode *node, size_t minParts) const
+{
+    vector<NodePtr> parts{node->shared_from_this()};
+
+    for(size_t level=0; parts.size() < minParts; ++level) {
+        if(level >= MAX_TREE_LEVEL)
+            throw FsDamagedException("Tree has more levels than btrfs allows.");
+
+        vector<NodePtr> children;
+        bool expanded(false);
+        for(auto &part : parts) {
+            if(part->nodeHeader->isLeafNode()) {
+                children.push_back(part);
+                continue;
+            }
+
+            const InternalNode *internal = static_cast<const InternalNode*>(part.get());
+            prefetchChildren(internal, 0, internal->keyPointers.size());
+            for(size_t i=0; i<internal->keyPointers.size(); ++i) {
+                NodePtr child = getNode(internal->keyPointers[i]->getBlkNum());
+                if(child != nullptr)
+                    children.push_back(child);
+            }
+            expanded = true;
+        }
+        if(!expanded)
+            break;
+        parts.swap(children);
+    }
+    return parts;
+}
+
+
+//! Return maximum number of image reads in flight.
+unsigned BtrfsPool::getQueueDepth() const
+{
+    return readEngine->getQueueDepth();
+}
+
+
+//! Hint the access pattern of data at a logical address.
 //!
-//! \param[out] data Array with data read from image
 //! \param logicalAddr Logical address of data.
 //! \param size Size of data.
+//! \param hint Expected access pattern.
 //!
-//! \return Starting physcial address of data in the image.
-//! 
-uint64_t BtrfsPool::readData(char *data, uint64_t logicalAddr,
-                            const uint64_t size) const
+void BtrfsPool::adviseData(uint64_t logicalAddr, uint64_t size, AccessHint hint) const
+{
+    uint64_t advised(0);
+    while(advised < size) {
+        uint64_t physicalAddr, length;
+        if(!chunkMap.mapAddress(logicalAddr + advised, physicalAddr, length))
+            return;
+        length = min(length, size - advised);
+        imgSource->advise(physicalAddr, length, hint);
+        advised += length;
+    }
+}
+
+
+//! Read a whole node from image with one request and parse it.
+//!
+//! The node is parsed in place when the image source supports views.
+//!
+//! \param logicalAddr Logical address of the node.
+//!
+//! \return Leaf node or internal node built from the data.
+//!
+NodePtr BtrfsPool::readNode(uint64_t logicalAddr) const
+{
+    uint32_t nodeSize = primarySupblk->nodeSize;
+
+    uint64_t physicalAddr, length;
+    if(chunkMap.mapAddress(logicalAddr, physicalAddr, length) && length >= nodeSize) {
+        const char *nodeView = imgSource->view(physicalAddr, nodeSize);
+        if(nodeView != nullptr)
+            return NodePtr(buildNode(nodeView, physicalAddr));
+    }
+
+    char *nodeArr = new char[nodeSize]();
+    physicalAddr = readData(nodeArr, logicalAddr, nodeSize);
+
+    NodePtr node(buildNode(nodeArr, physicalAddr));
+    delete [] nodeArr;
+
+    return node;
+}
+
+
+//! Get a node from the node cache, reading it from image if not cached.
+//!
+//! Safe to call from several threads. A node missing from the cache is
+//! read by one thread only, others asking for it wait for that read.
+//!
+//! \param logicalAddr Logical address of the node.
+//!
+//! \return The node, pinned in the cache while the pointer is held.
+//!
+NodePtr BtrfsPool::getNode(uint64_t logicalAddr) const
+{
+    NodePtr node = nodeCache.find(logicalAddr);
+    if(node != nullptr)
+        return node;
+
+    std::promise<NodePtr> loaded;
+    std::shared_future<NodePtr> pending;
+    {
+        std::lock_guard<std::mutex> guard(loadLock);
+        auto found = loadingNodes.find(logicalAddr);
+        if(found != loadingNodes.end())
+            pending = found->second;
+        else
+            loadingNodes[logicalAddr] = loaded.get_future().share();
+    }
+    if(pending.valid())
+        return pending.get();
+
+    try {
+        //Another thread may have finished loading it after the first lookup.
+        node = nodeCache.find(logicalAddr);
+        if(node == nullptr) {
+            std::shared_ptr<NodePrefetcher> current = std::atomic_load(&prefetcher);
+            if(current != nullptr)
+                node = current->take(logicalAddr);
+            if(node == nullptr)
+                node = readNode(logicalAddr);
+            nodeCache.insert(logicalAddr, node, node->getFootprint());
+        }
+        loaded.set_value(node);
+    } catch(...) {
+        loaded.set_exception(std::current_exception());
+        std::lock_guard<std::mutex> guard(loadLock);
+        loadingNodes.erase(logicalAddr);
+        throw;
+    }
+
+    std::lock_guard<std::mutex> guard(loadLock);
+    loadingNodes.erase(logicalAddr);
+    return node;
+}
+
+
+//! Build a node from a buffer holding the whole node.
+//!
+//! \param nodeArr Byte array storing the node, size of nodeSize in superblock.
+//! \param physicalAddr Physical address of the node.
+//!
+//! \return Leaf node or internal node built from the data.
+//!
+BtrfsNode* BtrfsPool::buildNode(const char *nodeArr, uint64_t physicalAddr) const
 {
-    const ChunkItem* chunk = chunkTree->getChunkItem(logicalAddr);
-    return readChunkData(data, logicalAddr, &(chunk->itemHead->key), &(chunk->data), size);
+    uint32_t nodeSize = primarySupblk->nodeSize;
+    //Parsing only reads from the array.
+    uint8_t *arr = (uint8_t*)nodeArr;
+    BtrfsHeader *header = new BtrfsHeader(endian, arr);
+
+    if(header->isLeafNode())
+        return new LeafNode(header, endian, arr, nodeSize, physicalAddr);
+    else
+        return new InternalNode(header, endian, arr, nodeSize);
 }
 
 
@@ -204,17 +520,7 @@ void BtrfsPool::initializeRootTree()
 {
     uint64_t rootTreeLogAddr = primarySupblk->getRootLogAddr();
 
-    char* diskArr = new char[BtrfsHeader::SIZE_OF_HEADER]();
-    uint64_t rootTreePhyAddr = readData(diskArr, rootTreeLogAddr, BtrfsHeader::SIZE_OF_HEADER);
-
-    BtrfsHeader* rootHeader = new BtrfsHeader(endian, (uint8_t*)diskArr);
-    delete [] diskArr;
-
-    uint64_t itemListStart = rootTreePhyAddr + BtrfsHeader::SIZE_OF_HEADER;
-    if(rootHeader->isLeafNode())
-        rootTree = new LeafNode(image, rootHeader, endian, itemListStart);
-    else
-        rootTree = new InternalNode(image, rootHeader, endian, itemListStart);
+    rootTree = getNode(rootTreeLogAddr);
 }
 
 
@@ -227,15 +533,14 @@ void BtrfsPool::initializeFileTree(uint64_t fsRootId)
     if(fsRootId == 0){
         uint64_t defaultId = getDefaultFsId();
 
-        fsTree = new FilesystemTree(rootTree, defaultId, this);
+        fsTree = new FilesystemTree(rootTree.get(), defaultId, this);
         fsTreeDefault = fsTree;
     }
     else{
-        const BtrfsItem* foundItem;
-        if(treeSearchById(rootTree, fsRootId,
-            [&foundItem](const LeafNode* leaf, uint64_t targetId)
-            { return searchForItem(leaf, targetId, ItemType::ROOT_BACKREF, foundItem); })) {
-            fsTree = new FilesystemTree(rootTree, fsRootId, this);
+        ItemPtr foundItem;
+        TreeCursor cursor(this, rootTree.get());
+        if(searchForItem(cursor, fsRootId, ItemType::ROOT_BACKREF, foundItem)) {
+            fsTree = new FilesystemTree(rootTree.get(), fsRootId, this);
             fsTreeDefault = fsTree;
         }
         else
@@ -252,11 +557,10 @@ uint64_t BtrfsPool::getDefaultFsId()
     uint64_t defaultDirId(6);
 
     uint64_t defaultId(0);
-    const BtrfsItem* foundItem;
-    if(treeSearchById(rootTree, defaultDirId,
-            [&foundItem](const LeafNode* leaf, uint64_t targetId)
-            { return searchForItem(leaf, targetId, ItemType::DIR_ITEM, foundItem); })) {
-        const DirItem* dir = static_cast<const DirItem*>(foundItem);
+    ItemPtr foundItem;
+    TreeCursor cursor(this, rootTree.get());
+    if(searchForItem(cursor, defaultDirId, ItemType::DIR_ITEM, foundItem)) {
+        const DirItem* dir = static_cast<const DirItem*>(foundItem.get());
         defaultId = dir->targetKey.objId; //This is id of root item to filesystem tree.
     }
     else 
@@ -277,6 +581,7 @@ void BtrfsPool::navigateNodes(const BtrfsNode* root,
 {
     const BtrfsNode *node = root;
     const BtrfsHeader *header;
+    NodePtr nodeHolder; //Keeps current node pinned in the cache.
     while(true) {
         header = node->nodeHeader;
         os << node->info() << endl;
@@ -286,10 +591,11 @@ void BtrfsPool::navigateNodes(const BtrfsNode* root,
         if(header->isLeafNode()){
             const LeafNode *leaf = static_cast<const LeafNode*>(node);
 
-            for(auto item : leaf->itemList){
-                if(item->getItemType() == ItemType::ROOT_ITEM){
-                    const RootItem *rootItm = static_cast<const RootItem*>(item);
-                    nodeAddrs[item->getId()]
+            for(uint32_t i=0; i<leaf->getNumOfItems(); ++i){
+                if(leaf->getItemType(i) == ItemType::ROOT_ITEM){
+                    const RootItem *rootItm =
+                        static_cast<const RootItem*>(leaf->getItem(i));
+                    nodeAddrs[leaf->getObjId(i)]
                         = rootItm->getBlockNumber();
                 }
             }
@@ -332,43 +638,9 @@ void BtrfsPool::navigateNodes(const BtrfsNode* root,
         }
         os << endl;
 
-        bool nodeExisted(false);
-        using ConstNodePtr = const BtrfsNode*;
-        ConstNodePtr* childPtr(nullptr);
-        if(!header->isLeafNode()) {
-            const InternalNode* internal = static_cast<const InternalNode*>(node);
-
-            for(auto ptr : internal->keyPointers) {
-                if(ptr->key.objId == inputId && ptr->childNode != nullptr) {
-                    node = ptr->childNode;
-                    nodeExisted = true;
-                    break;
-                }
-                else if(ptr->key.objId == inputId) {
-                    childPtr = &ptr->childNode;
-                    break;
-                }
-            }
-        }
-        if(nodeExisted) continue; //The child node has already been built.
-
         offset = nodeAddrs[inputId];
-        char *headerArr = new char[BtrfsHeader::SIZE_OF_HEADER]();
-        uint64_t physicalAddr = readData(headerArr, offset, BtrfsHeader::SIZE_OF_HEADER);
-        header = new BtrfsHeader(TSK_LIT_ENDIAN, (uint8_t*)headerArr);
-        delete [] headerArr;
-
-        uint64_t itemOffset = physicalAddr + BtrfsHeader::SIZE_OF_HEADER;
-
-        if(header->isLeafNode()){
-            node = new LeafNode(image, header, endian, itemOffset);
-        }
-        else {
-            node = new InternalNode(image, header, endian, itemOffset);
-        }
-
-        if(childPtr!=nullptr)
-            *childPtr = node;
+        nodeHolder = getNode(offset);
+        node = nodeHolder.get();
     }
 }
 
@@ -381,9 +653,8 @@ void BtrfsPool::navigateNodes(const BtrfsNode* root,
 //!
 bool BtrfsPool::switchFsTrees(ostream& os, istream& is)
 {
-    vector<const BtrfsItem*> foundRootRefs;
-    treeTraverse(rootTree, [&foundRootRefs](const LeafNode* leaf)
-            { return filterItems(leaf, ItemType::ROOT_BACKREF, foundRootRefs); });
+    vector<ItemPtr> foundRootRefs;
+    findSubvolumes(foundRootRefs);
     
     if(foundRootRefs.size() == 0) {
         os << "\nNo subvolumes or snapshots are found.\n" << endl;
@@ -395,9 +666,9 @@ bool BtrfsPool::switchFsTrees(ostream& os, istream& is)
         os << "The following subvolumes or snapshots are found:" << endl;
         int index(0);
         for(auto item : foundRootRefs) {
-            const RootRef* ref = static_cast<const RootRef*>(item);
+            const RootRef* ref = static_cast<const RootRef*>(item.get());
             os << "[" << dec << setfill(' ') << setw(2) << ++index << "] "
-                << setw(7) << ref->getId() << "   " << ref->getDirName() << '\n';
+                << setw(7) << ref->getSubvolId() << "   " << ref->getDirName() << '\n';
         }
         os << endl;
 
@@ -410,224 +681,82 @@ bool BtrfsPool::switchFsTrees(ostream& os, istream& is)
         int inputIndex;
         stringstream(input) >> inputIndex;
         if(inputIndex > 0 && inputIndex <= foundRootRefs.size()) {
-            selectedId = foundRootRefs[inputIndex-1]->getId();
+            selectedId = static_cast<const RootRef*>(foundRootRefs[inputIndex-1].get())->getSubvolId();
             break;
         }
         os << "Wrong index, please enter a correct one.\n\n\n" << endl;
     }
     
-    fsTree = new FilesystemTree(rootTree, selectedId, this);
+    fsTree = new FilesystemTree(rootTree.get(), selectedId, this);
     os << "\n" << std::string(60, '=') << "\n";
     os << endl;
     return true;
 }
 
 
-//! Recursively traverse child nodes and process it if it is a leaf node.
-//!
-//! \param node Node being processed.
-//! \param readOnlyFunc A function type which accepts a LeafNode* 
-//!        and a vector<uint64_t>& parameters and returns void.
-//!
-void BtrfsPool::treeTraverse(const BtrfsNode *node,
-        function<void(const LeafNode*)> readOnlyFunc) const
-{
-    if(node->nodeHeader->isLeafNode()){
-        const LeafNode* leaf = static_cast<const LeafNode*>(node);
-        readOnlyFunc(leaf);
-    }
-    else {
-        const InternalNode* internal = static_cast<const InternalNode*>(node);
-        const BtrfsNode *newNode;
-
-        for(auto ptr : internal->keyPointers) {
-            if(ptr->childNode != nullptr) {
-                newNode = ptr->childNode;
-            }
-            else {
-                char *headerArr = new char[BtrfsHeader::SIZE_OF_HEADER]();
-                uint64_t physicalAddr = readData(headerArr, ptr->getBlkNum(),
-                    BtrfsHeader::SIZE_OF_HEADER);
-                BtrfsHeader *header = new BtrfsHeader(TSK_LIT_ENDIAN, (uint8_t*)headerArr);
-                delete [] headerArr; 
-
-                uint64_t itemOffset = physicalAddr + BtrfsHeader::SIZE_OF_HEADER;
-
-                if(header->isLeafNode()){
-                    newNode = new LeafNode(image, header, endian, itemOffset);
-                }
-                else {
-                    newNode = new InternalNode(image, header, endian, itemOffset);
-                }
-
-                ptr->childNode = newNode;
-            }
-
-            if(newNode != nullptr)
-                treeTraverse(newNode, readOnlyFunc);
-        }
-    }
-}
 
-
-//! Recursively traverse nodes in chunk tree and search if it is a leaf node.
-//!
-//! \param node Node being processed.
-//! \param searchFunc A function type which accepts a LeafNode* 
-//!        parameter and returns true if certain object is found.
-//! \return True if target is found in leaf node.
+//! Find all subvolumes and snapshots.
 //!
-bool BtrfsPool::chunkTreeSearch(const BtrfsNode *node,
-        function<bool(const LeafNode*)> searchFunc) const
-{
-    if(node->nodeHeader->isLeafNode()){
-        const LeafNode *leaf = static_cast<const LeafNode*>(node);
-        return searchFunc(leaf);
-    }
-    else {
-        const InternalNode *internal = static_cast<const InternalNode*>(node);
-        const BtrfsNode *newNode;
-
-        for(auto ptr : internal->keyPointers) {
-            if(ptr->childNode != nullptr) {
-                newNode = ptr->childNode;
-            }
-            else {
-                const SuperBlock *supBlk = primarySupblk;
-                char *headerArr = new char[BtrfsHeader::SIZE_OF_HEADER]();
-                uint64_t physicalAddr = readChunkData(headerArr, ptr->getBlkNum(),
-                    &(supBlk->chunkKey), &(supBlk->chunkData),
-                    BtrfsHeader::SIZE_OF_HEADER);
-
-                BtrfsHeader *header = new BtrfsHeader(TSK_LIT_ENDIAN, (uint8_t*)headerArr);
-                delete [] headerArr; 
-
-                uint64_t itemOffset = physicalAddr + BtrfsHeader::SIZE_OF_HEADER;
-                
-                if(header->isLeafNode()){
-                    newNode = new LeafNode(image, header, endian, itemOffset);
-                }
-                else {
-                    newNode = new InternalNode(image, header, endian, itemOffset);
-                }
-
-                ptr->childNode = newNode;
-            }
-
-            if(newNode != nullptr && treeSearch(newNode, searchFunc))
-                return true;
-        }
-        return false;
-    }
-}
-
-
-//! Recursively traverse child nodes and search if it is a leaf node.
+//! Root refs of the children of a tree are adjacent under its id, so
+//! starting from the top level tree, one range scan per found subvolume
+//! finds all of them without walking the whole root tree.
 //!
-//! \param node Node being processed.
-//! \param searchFunc A function type which accepts a LeafNode* 
-//!        parameter and returns true if certain object is found.
-//! \return True if target is found in leaf node.
+//! \param refs Vector receiving root refs of all subvolumes, ordered by subvolume id.
 //!
-bool BtrfsPool::treeSearch(const BtrfsNode *node,
-        function<bool(const LeafNode*)> searchFunc) const
+void BtrfsPool::findSubvolumes(std::vector<ItemPtr> &refs) const
 {
-    if(node->nodeHeader->isLeafNode()){
-        const LeafNode *leaf = static_cast<const LeafNode*>(node);
-        return searchFunc(leaf);
-    }
-    else {
-        const InternalNode *internal = static_cast<const InternalNode*>(node);
-        const BtrfsNode *newNode;
-
-        for(auto ptr : internal->keyPointers) {
-            if(ptr->childNode != nullptr) {
-                newNode = ptr->childNode;
-            }
-            else {
-                char *headerArr = new char[BtrfsHeader::SIZE_OF_HEADER]();
-                uint64_t physicalAddr = readData(headerArr, ptr->getBlkNum(),
-                    BtrfsHeader::SIZE_OF_HEADER);
-
-                BtrfsHeader *header = new BtrfsHeader(TSK_LIT_ENDIAN, (uint8_t*)headerArr);
-                delete [] headerArr; 
-
-                uint64_t itemOffset = physicalAddr + BtrfsHeader::SIZE_OF_HEADER;
-                
-                if(header->isLeafNode()){
-                    newNode = new LeafNode(image, header, endian, itemOffset);
-                }
-                else {
-                    newNode = new InternalNode(image, header, endian, itemOffset);
-                }
-
-                ptr->childNode = newNode;
-            }
-
-            if(newNode != nullptr && treeSearch(newNode, searchFunc))
-                return true;
+    map<uint64_t, ItemPtr> found;
+    vector<uint64_t> parents;
+    parents.push_back(uint64_t(FS_TREE_ID));
+    TreeCursor cursor(this, rootTree.get());
+    while(!parents.empty()) {
+        uint64_t parent = parents.back();
+        parents.pop_back();
+
+        vector<ItemPtr> children;
+        filterItems(cursor, parent, ItemType::ROOT_REF, children);
+        for(auto &child : children) {
+            uint64_t id = static_cast<const RootRef*>(child.get())->getSubvolId();
+            //A damaged tree may contain a subvolume inside itself.
+            if(found.insert(make_pair(id, child)).second)
+                parents.push_back(id);
         }
-        return false;
     }
+
+    for(auto &entry : found)
+        refs.push_back(entry.second);
 }
 
 
-//! Recursively traverse child nodes and search if it is a leaf node.
+//! Find subvolumes with a UUID in the UUID tree.
+//!
+//! \param uuid UUID in the byte order stored on disk.
+//! \param type UUID_SUBVOL to match UUID of subvolumes,
+//!             UUID_RECEIVED_SUBVOL to match UUID they are received from.
+//! \param ids Vector receiving ids of the found subvolumes.
 //!
-//! \param node Node being processed.
-//! \param targetId Object id of target to search for.
-//! \param searchFunc A function type which accepts a LeafNode* 
-//!        parameter and returns true if certain object is found.
-//! \return True if target is found in leaf node.
+//! \return True if any subvolume is found.
 //!
-bool BtrfsPool::treeSearchById(const BtrfsNode *node, uint64_t targetId,
-        function<bool(const LeafNode*, uint64_t)> searchFunc) const
+bool BtrfsPool::findSubvolsByUuid(const uint8_t uuid[], ItemType type, std::vector<uint64_t> &ids) const
 {
-    if(node->nodeHeader->isLeafNode()){
-        const LeafNode *leaf = static_cast<const LeafNode*>(node);
-        return searchFunc(leaf, targetId);
-    }
-    else {
-        const InternalNode *internal = static_cast<const InternalNode*>(node);
-        const BtrfsNode *newNode;
-
-        const auto &vecPtr = internal->keyPointers;
-        for(int i=0; i<vecPtr.size();++i) {
-            auto ptr = vecPtr[i];
-            if(ptr->key.objId > targetId)
-                return false;
-            if(ptr->key.objId<targetId && i!=vecPtr.size()-1
-                    && vecPtr[i+1]->key.objId<targetId)
-                continue;
-
-            if(ptr->childNode != nullptr) {
-                newNode = ptr->childNode;
-            }
-            else {
-                char *headerArr = new char[BtrfsHeader::SIZE_OF_HEADER]();
-                uint64_t physicalAddr = readData(headerArr, ptr->getBlkNum(),
-                    BtrfsHeader::SIZE_OF_HEADER);
-                BtrfsHeader *header = new BtrfsHeader(TSK_LIT_ENDIAN, (uint8_t*)headerArr);
-                delete [] headerArr; 
-
-                uint64_t itemOffset = physicalAddr + BtrfsHeader::SIZE_OF_HEADER;
-                
-                if(header->isLeafNode()){
-                    newNode = new LeafNode(image, header, endian, itemOffset);
-                }
-                else {
-                    newNode = new InternalNode(image, header, endian, itemOffset);
-                }
-
-                ptr->childNode = newNode;
-            }
+    //The UUID tree is missing in filesystems created by old kernels.
+    ItemPtr foundItem;
+    TreeCursor rootCursor(this, rootTree.get());
+    if(!searchForItem(rootCursor, UUID_TREE_ID, ItemType::ROOT_ITEM, foundItem))
+        return false;
+    NodePtr uuidRoot = getNode(static_cast<const RootItem*>(foundItem.get())->getBlockNumber());
 
-            if(newNode != nullptr && treeSearchById(newNode, targetId, searchFunc))
-                return true;
-        }
+    //The UUID is split into object id and offset of the key.
+    BtrfsKey key(read64Bit(endian, uuid), type, read64Bit(endian, uuid + 8));
+    TreeCursor cursor(this, uuidRoot.get());
+    if(!cursor.seek(key) || !(cursor.getKey() == key))
         return false;
-    }
-}
 
+    foundItem = cursor.getItem();
+    const UuidItem *uuidItem = static_cast<const UuidItem*>(foundItem.get());
+    for(uint32_t i = 0; i < uuidItem->getNumOfIds(); ++i)
+        ids.push_back(uuidItem->getSubvolId(i));
+    return uuidItem->getNumOfIds() > 0;
 }
 
+}
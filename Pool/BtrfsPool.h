@@ -7,10 +7,23 @@
 #define BTRFS_POOL_H
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
-#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <atomic>
+#include <future>
 #include "DeviceRecord.h"
+#include "ChunkMap.h"
+#include "ImageSource.h"
+#include "ReadEngine.h"
+#include "NodePrefetcher.h"
+#include "NodeCache.h"
+#include "TaskQueues.h"
+#include "PathResolver.h"
 #include "Basics/Basics.h"
 #include "Trees/Trees.h"
 
@@ -20,6 +33,8 @@ namespace btrForensics {
     class BtrfsPool {
     public:
         TSK_IMG_INFO *image;  //!< Image file
+        ImageSource *imgSource; //!< Backend reading the image.
+        ReadEngine *readEngine; //!< Submits batches of image reads.
         TSK_ENDIAN_ENUM endian; //!< Endianness.
 
         UUID fsUUID; //!< Filesystem UUID
@@ -30,7 +45,22 @@ namespace btrForensics {
         ChunkTree* chunkTree; //!< The chunk tree.
         FilesystemTree* fsTree; //!< The file system tree.
         FilesystemTree* fsTreeDefault; //!< Default file system tree.
-        const BtrfsNode* rootTree; //!< Root node of the root tree.
+        NodePtr rootTree; //!< Root node of the root tree.
+
+        ChunkMap chunkMap; //!< Logical to physical mapping of all chunks.
+
+        mutable NodeCache nodeCache; //!< Parsed nodes shared by all trees of the pool.
+        PathResolver pathResolver; //!< Full paths of inodes in all trees of the pool.
+        mutable std::shared_ptr<NodePrefetcher> prefetcher; //!< Reads nodes ahead of tree walks, created on first use, accessed atomically.
+        mutable std::mutex prefetcherLock; //!< Serializes creation of the prefetcher.
+        mutable std::mutex engineLock; //!< Serializes batches of the read engine.
+        mutable std::mutex loadLock; //!< Guards loadingNodes.
+        mutable std::map<uint64_t, std::shared_future<NodePtr>> loadingNodes; //!< Nodes being read by a thread.
+        std::atomic<uint64_t> prefetchBudget; //!< Bytes of nodes read ahead, 0 to disable.
+        unsigned threadCount; //!< Number of threads of parallel tree walks.
+
+        static const uint64_t DEFAULT_PREFETCH_BUDGET = 4 * 1024 * 1024; //!< Default read ahead of tree walks.
+        static const size_t PREFETCH_WINDOW = 32; //!< Children read ahead of a walk in one internal node.
 
     public:
         BtrfsPool(TSK_IMG_INFO*, TSK_ENDIAN_ENUM, vector<TSK_OFF_T>, uint64_t = 0);
@@ -39,11 +69,24 @@ namespace btrForensics {
         std::string devInfo() const;
         uint64_t getDevOffset(uint64_t devId) const;
 
-        std::vector<uint64_t> getAddrFromChunk(uint64_t logicalAddr,
-                const BtrfsKey* key, const ChunkData* chunkData) const;
-        uint64_t readChunkData(char *data, uint64_t logicalAddr,
-                const BtrfsKey* key, const ChunkData* chunkData, uint64_t size) const;
+        bool mapChunk(uint64_t logicalAddr, const ChunkData* chunkData);
         uint64_t readData(char *data, uint64_t logicalAddr, uint64_t size) const;
+        std::vector<ReadRequest> mapRequests(const std::vector<ReadRequest> &requests) const;
+        void readDataBatch(const std::vector<ReadRequest> &requests) const;
+        void adviseData(uint64_t logicalAddr, uint64_t size, AccessHint hint) const;
+
+        void setQueueDepth(unsigned depth);
+        unsigned getQueueDepth() const;
+        void setPrefetchBudget(uint64_t budget);
+        void setThreads(unsigned threads);
+        //! Return number of threads of parallel tree walks.
+        unsigned getThreads() const { return threadCount; }
+
+        NodePtr readNode(uint64_t logicalAddr) const;
+        NodePtr getNode(uint64_t logicalAddr) const;
+        void prefetchChildren(const InternalNode *node, size_t first, size_t count) const;
+        std::vector<NodePtr> splitTree(const BtrfsNode *node, size_t minParts) const;
+        BtrfsNode* buildNode(const char *nodeArr, uint64_t physicalAddr) const;
 
 
         void initializeChunkTree();
@@ -53,19 +96,180 @@ namespace btrForensics {
 
         void navigateNodes(const BtrfsNode* root, std::ostream& os, std::istream& is) const;
         bool switchFsTrees(std::ostream& os, std::istream& is);
+        void findSubvolumes(std::vector<ItemPtr> &refs) const;
+        bool findSubvolsByUuid(const uint8_t uuid[], ItemType type, std::vector<uint64_t> &ids) const;
 
-        void treeTraverse(const BtrfsNode* node,
-            std::function<void(const LeafNode*)> readOnlyFunc) const;
+        template<typename Visitor>
+        void treeTraverse(const BtrfsNode* node, Visitor readOnlyFunc) const;
 
-        bool chunkTreeSearch(const BtrfsNode* node,
-            std::function<bool(const LeafNode*)> searchFunc) const;
+        template<typename Visitor>
+        bool treeSearch(const BtrfsNode* node, Visitor searchFunc) const;
 
-        bool treeSearch(const BtrfsNode* node,
-            std::function<bool(const LeafNode*)> searchFunc) const;
+        template<typename Buffer, typename Visitor, typename Consumer>
+        void parallelTraverse(const BtrfsNode* node, Visitor visitor, Consumer consumer) const;
 
-        bool treeSearchById(const BtrfsNode* node, uint64_t targetId,
-            std::function<bool(const LeafNode*, uint64_t)> searchFunc) const;
+        static const size_t MAX_TREE_LEVEL = 8; //!< Maximum number of levels in a btrfs tree.
+        static const uint64_t FS_TREE_ID = 5; //!< Id of the top level filesystem tree.
+        static const uint64_t UUID_TREE_ID = 9; //!< Id of the UUID tree.
+        static const unsigned SUBTREES_PER_THREAD = 4; //!< Subtrees split per thread in parallel walks.
+        static const unsigned MAX_THREADS = 256; //!< Maximum number of threads of parallel tree walks.
+
+    private:
+        std::shared_ptr<NodePrefetcher> startPrefetcher() const;
     };
+
+
+    //! Visit all leaf nodes under a node in key order.
+    //!
+    //! \param node Node being processed.
+    //! \param readOnlyFunc A callable which accepts a LeafNode* parameter.
+    //!
+    template<typename Visitor>
+    void BtrfsPool::treeTraverse(const BtrfsNode *node, Visitor readOnlyFunc) const
+    {
+        treeSearch(node, [&readOnlyFunc](const LeafNode *leaf)
+            { readOnlyFunc(leaf); return false; });
+    }
+
+
+    //! Visit leaf nodes under a node in key order until the visitor returns true.
+    //!
+    //! The walk keeps its own stack of internal nodes instead of recursing,
+    //! and the visitor is called directly so it can be inlined.
+    //!
+    //! \param node Node being processed.
+    //! \param searchFunc A callable which accepts a LeafNode*
+    //!        parameter and returns true if certain object is found.
+    //! \return True if target is found in leaf node.
+    //!
+    template<typename Visitor>
+    bool BtrfsPool::treeSearch(const BtrfsNode *node, Visitor searchFunc) const
+    {
+        //Position in an internal node on the way down.
+        struct Level {
+            NodePtr node;
+            size_t index;
+        };
+        std::vector<Level> stack;
+        NodePtr current = node->shared_from_this();
+
+        while(true) {
+            if(current != nullptr) {
+                if(current->nodeHeader->isLeafNode()) {
+                    if(searchFunc(static_cast<const LeafNode*>(current.get())))
+                        return true;
+                }
+                else {
+                    if(stack.size() >= MAX_TREE_LEVEL)
+                        throw FsDamagedException("Tree has more levels than btrfs allows.");
+                    stack.push_back(Level{current, 0});
+                }
+                current.reset();
+            }
+
+            if(stack.empty())
+                return false;
+
+            Level &top = stack.back();
+            const InternalNode *internal = static_cast<const InternalNode*>(top.node.get());
+            if(top.index < internal->keyPointers.size()) {
+                //Keep the following siblings on the way while this subtree is walked,
+                //the window is requested on entry and then moved by one child.
+                if(top.index == 0)
+                    prefetchChildren(internal, 0, PREFETCH_WINDOW);
+                else
+                    prefetchChildren(internal, top.index + PREFETCH_WINDOW - 1, 1);
+                current = getNode(internal->keyPointers[top.index++]->getBlkNum());
+            }
+            else
+                stack.pop_back();
+        }
+    }
+
+
+    //! Visit all leaf nodes under a node on several threads.
+    //!
+    //! The tree is split at key pointers into subtrees, which workers walk
+    //! independently, stealing subtrees from each other when idle.
+    //! Each subtree has its own result buffer, so the visitor needs no locking.
+    //! Buffers are passed to the consumer on the calling thread in key order,
+    //! each one as soon as it and all buffers before it are complete.
+    //!
+    //! \param node Node being processed.
+    //! \param visitor A callable which accepts a LeafNode* and a Buffer&.
+    //! \param consumer A callable which accepts a Buffer&, the buffer is released afterwards.
+    //!
+    template<typename Buffer, typename Visitor, typename Consumer>
+    void BtrfsPool::parallelTraverse(const BtrfsNode *node, Visitor visitor, Consumer consumer) const
+    {
+        unsigned threads = threadCount;
+        std::vector<NodePtr> subtrees = splitTree(node, (size_t)threads * SUBTREES_PER_THREAD);
+        std::vector<Buffer> results(subtrees.size());
+
+        auto walkSubtree = [&](size_t index) {
+            Buffer &buffer = results[index];
+            treeTraverse(subtrees[index].get(),
+                [&visitor, &buffer](const LeafNode *leaf) { visitor(leaf, buffer); });
+        };
+
+        if(threads > subtrees.size())
+            threads = subtrees.size();
+        if(threads <= 1) {
+            for(size_t i=0; i<subtrees.size(); ++i) {
+                walkSubtree(i);
+                consumer(results[i]);
+                results[i] = Buffer();
+            }
+            return;
+        }
+
+        TaskQueues queues(threads, subtrees.size());
+        std::exception_ptr failure;
+        std::vector<bool> finished(subtrees.size(), false);
+        std::mutex finishLock;
+        std::condition_variable finishChanged;
+        std::vector<std::thread> workers;
+        for(unsigned w=0; w<threads; ++w) {
+            workers.emplace_back([&, w]() {
+                size_t index;
+                while(queues.pop(w, index)) {
+                    std::exception_ptr error;
+                    try {
+                        walkSubtree(index);
+                    } catch(...) {
+                        error = std::current_exception();
+                    }
+                    std::lock_guard<std::mutex> guard(finishLock);
+                    if(error && !failure)
+                        failure = error;
+                    finished[index] = true;
+                    finishChanged.notify_all();
+                }
+            });
+        }
+
+        for(size_t i=0; i<subtrees.size(); ++i) {
+            std::unique_lock<std::mutex> guard(finishLock);
+            finishChanged.wait(guard, [&]() { return finished[i] || failure; });
+            if(failure)
+                break;
+            guard.unlock();
+            try {
+                consumer(results[i]);
+            } catch(...) {
+                guard.lock();
+                if(!failure)
+                    failure = std::current_exception();
+                break;
+            }
+            results[i] = Buffer();
+        }
+        for(auto &worker : workers)
+            worker.join();
+
+        if(failure)
+            std::rethrow_exception(failure);
+    }
 }
 
 #endif
@@ -0,0 +1,140 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class ChunkMap.
+
+#include <algorithm>
+#include "ChunkMap.h"
+#include "Basics/Exceptions.h"
+
+namespace btrForensics {
+
+//! Constructor of chunk map.
+ChunkMap::ChunkMap()
+    :lastHit(0)
+{
+}
+
+
+//! Add a chunk to the map, keeping chunks sorted by logical address.
+//!
+//! \param range Address range of the chunk, firstStripe is ignored.
+//! \param rangeStripes Stripes of the chunk.
+//!
+//! \return False if a chunk with the same logical address is mapped already.
+//!
+bool ChunkMap::insert(ChunkRange range, const std::vector<ChunkStripe> &rangeStripes)
+{
+    auto pos = std::lower_bound(ranges.begin(), ranges.end(), range.logicalAddr,
+            [](const ChunkRange &r, uint64_t addr) { return r.logicalAddr < addr; });
+    if(pos != ranges.end() && pos->logicalAddr == range.logicalAddr)
+        return false;
+
+    if(rangeStripes.size() == 0)
+        throw FsDamagedException("Chunk item error. No stripe found.");
+
+    range.firstStripe = stripes.size();
+    range.numStripe = rangeStripes.size();
+    stripes.insert(stripes.end(), rangeStripes.begin(), rangeStripes.end());
+
+    ranges.insert(pos, range);
+    lastHit.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+
+//! Find the chunk covering a logical address.
+//!
+//! The chunk found by last lookup is checked first,
+//! since reads are often sequential.
+//!
+//! \param logicalAddr Logical address to look up.
+//!
+//! \return The chunk, nullptr if the address is not mapped.
+//!
+const ChunkRange* ChunkMap::find(uint64_t logicalAddr) const
+{
+    size_t hit = lastHit.load(std::memory_order_relaxed);
+    if(hit < ranges.size()) {
+        const ChunkRange &last = ranges[hit];
+        if(logicalAddr >= last.logicalAddr && logicalAddr - last.logicalAddr < last.size)
+            return &last;
+    }
+
+    //First chunk starting after the address.
+    auto pos = std::upper_bound(ranges.begin(), ranges.end(), logicalAddr,
+            [](uint64_t addr, const ChunkRange &r) { return addr < r.logicalAddr; });
+    if(pos == ranges.begin())
+        return nullptr;
+    --pos;
+    if(logicalAddr - pos->logicalAddr >= pos->size)
+        return nullptr;
+
+    lastHit.store(pos - ranges.begin(), std::memory_order_relaxed);
+    return &(*pos);
+}
+
+
+//! Translate a logical address to a physical address in the image.
+//!
+//! For mirrored profiles the first copy is used.
+//!
+//! \param logicalAddr Logical address to translate.
+//! \param[out] physicalAddr Mapped physical address.
+//! \param[out] length Bytes physically contiguous from the mapped address.
+//!
+//! \return False if the address is not mapped.
+//!
+bool ChunkMap::mapAddress(uint64_t logicalAddr,
+        uint64_t &physicalAddr, uint64_t &length) const
+{
+    const ChunkRange *chunk = find(logicalAddr);
+    if(chunk == nullptr)
+        return false;
+
+    uint64_t offset = logicalAddr - chunk->logicalAddr;
+    const ChunkStripe *chunkStripes = &stripes[chunk->firstStripe];
+
+    uint64_t striped = ChunkRange::RAID0 | ChunkRange::RAID10
+                        | ChunkRange::RAID5 | ChunkRange::RAID6;
+    if((chunk->type & striped) == 0 || chunk->stripeLength == 0) {
+        //Single, DUP and RAID1 store the whole chunk contiguously.
+        physicalAddr = chunkStripes[0].physicalAddr + offset;
+        length = chunk->size - offset;
+        return true;
+    }
+
+    uint64_t stripeNr = offset / chunk->stripeLength;
+    uint64_t stripeOffset = offset % chunk->stripeLength;
+    uint64_t stripeIndex(0);
+    uint64_t row(0);
+
+    if(chunk->type & ChunkRange::RAID0) {
+        stripeIndex = stripeNr % chunk->numStripe;
+        row = stripeNr / chunk->numStripe;
+    }
+    else if(chunk->type & ChunkRange::RAID10) {
+        uint64_t factor = chunk->numStripe / std::max<uint16_t>(chunk->subStripe, 1);
+        stripeIndex = (stripeNr % factor) * chunk->subStripe;
+        row = stripeNr / factor;
+    }
+    else {
+        //Parity rotates across stripes in RAID5 and RAID6.
+        uint64_t parity = (chunk->type & ChunkRange::RAID6) ? 2 : 1;
+        if(chunk->numStripe <= parity)
+            throw FsDamagedException("Chunk item error. Too few stripes for parity profile.");
+        uint64_t dataStripes = chunk->numStripe - parity;
+        row = stripeNr / dataStripes;
+        stripeIndex = (stripeNr % dataStripes + row) % chunk->numStripe;
+    }
+
+    if(stripeIndex >= chunk->numStripe)
+        throw FsDamagedException("Chunk item error. Stripe index out of range.");
+
+    physicalAddr = chunkStripes[stripeIndex].physicalAddr
+                    + row * chunk->stripeLength + stripeOffset;
+    length = std::min(chunk->stripeLength - stripeOffset, chunk->size - offset);
+    return true;
+}
+
+}
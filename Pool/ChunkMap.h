@@ -0,0 +1,65 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class ChunkMap.
+
+#ifndef CHUNK_MAP_H
+#define CHUNK_MAP_H
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace btrForensics {
+
+    //! Stripe of a mapped chunk.
+    class ChunkStripe {
+    public:
+        uint64_t deviceId; //!< ID of the device storing the stripe.
+        uint64_t physicalAddr; //!< Address of the stripe in the image.
+    };
+
+
+    //! Logical address range covered by a chunk.
+    class ChunkRange {
+    public:
+        uint64_t logicalAddr; //!< Logical address of the chunk.
+        uint64_t size; //!< Size of the chunk in bytes.
+        uint64_t stripeLength; //!< Length of a stripe.
+        uint64_t type; //!< Block group type and profile flags.
+        uint16_t numStripe; //!< Number of stripes.
+        uint16_t subStripe; //!< Number of sub stripes, used by RAID10.
+        uint32_t firstStripe; //!< Index of first stripe in the stripe array.
+
+        static const uint64_t RAID0 = 1 << 3; //!< Striped profile.
+        static const uint64_t RAID1 = 1 << 4; //!< Mirrored profile.
+        static const uint64_t DUP = 1 << 5; //!< Duplicated on one device.
+        static const uint64_t RAID10 = 1 << 6; //!< Striped and mirrored profile.
+        static const uint64_t RAID5 = 1 << 7; //!< Striped profile with one parity.
+        static const uint64_t RAID6 = 1 << 8; //!< Striped profile with two parities.
+    };
+
+
+    //! Flat, sorted map translating logical addresses to physical addresses.
+    class ChunkMap {
+    private:
+        std::vector<ChunkRange> ranges; //!< Sorted by logical address.
+        std::vector<ChunkStripe> stripes; //!< Stripes of all chunks.
+        mutable std::atomic<size_t> lastHit; //!< Index of the range found by last lookup.
+
+    public:
+        ChunkMap();
+        ~ChunkMap() = default; //!< Destructor
+
+        bool insert(ChunkRange range, const std::vector<ChunkStripe> &rangeStripes);
+
+        const ChunkRange* find(uint64_t logicalAddr) const;
+        bool mapAddress(uint64_t logicalAddr, uint64_t &physicalAddr, uint64_t &length) const;
+
+        //! Return number of chunks in the map.
+        size_t size() const { return ranges.size(); }
+    };
+}
+
+#endif
@@ -0,0 +1,102 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class DirReader.
+
+#include "DirReader.h"
+
+namespace btrForensics {
+
+//! Constructor of DirReader.
+//!
+//! \param pool Pool the tree belongs to.
+//! \param rootNode Root node of the filesystem tree.
+//!
+DirReader::DirReader(const BtrfsPool *pool, const BtrfsNode *rootNode)
+    :cursor(pool, rootNode), dirId(0), finished(true)
+{
+}
+
+
+//! Start reading a directory.
+//!
+//! The inode and its reference are read first, the cursor is then
+//! placed at the first index entry.
+//!
+//! \param id Inode number of the directory.
+//!
+//! \return True if inode of the directory is found.
+//!
+bool DirReader::open(uint64_t id)
+{
+    dirId = id;
+    finished = true;
+    inode.reset();
+    ref.reset();
+
+    for(bool valid = cursor.seek(BtrfsKey(id, ItemType::INODE_ITEM, 0)); valid; valid = cursor.next()) {
+        ItemType type = cursor.getItemType();
+        if(cursor.getObjId() != id || type > ItemType::INODE_REF)
+            break;
+        if(type == ItemType::INODE_ITEM && inode == nullptr)
+            inode = std::static_pointer_cast<const InodeItem>(cursor.getItem());
+        else if(type == ItemType::INODE_REF && ref == nullptr) {
+            ref = std::static_pointer_cast<const InodeRef>(cursor.getItem());
+            break;
+        }
+    }
+    if(inode == nullptr)
+        return false;
+
+    //Dir items with name hashes lie between, they are skipped with a seek.
+    cursor.seek(BtrfsKey(id, ItemType::DIR_INDEX, 0));
+    finished = false;
+    return true;
+}
+
+
+//! Read next batch of entries.
+//!
+//! \param batch Vector receiving the entries, previous content is removed.
+//! \param maxEntries Maximum number of entries to read.
+//!
+//! \return True if any entry is read.
+//!
+bool DirReader::read(std::vector<EntryPtr> &batch, size_t maxEntries)
+{
+    batch.clear();
+    while(!finished && batch.size() < maxEntries) {
+        if(!cursor.isValid() || cursor.getObjId() != dirId
+                || cursor.getItemType() != ItemType::DIR_INDEX) {
+            finished = true;
+            break;
+        }
+        batch.push_back(std::static_pointer_cast<const DirItem>(cursor.getItem()));
+        cursor.next();
+    }
+    return !batch.empty();
+}
+
+
+//! Return inode number of the parent directory.
+//!
+//! The directory itself is returned if its reference is not found.
+//!
+uint64_t DirReader::getParentId() const
+{
+    return ref == nullptr ? dirId : ref->itemHead->key.offset;
+}
+
+
+//! Return name of the directory, "/" for the root directory.
+std::string DirReader::getName() const
+{
+    if(ref == nullptr)
+        return "";
+    std::string name = ref->getDirName();
+    if(name == "..")  // This is the root directory.
+        name = "/";
+    return name;
+}
+
+}
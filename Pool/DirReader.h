@@ -0,0 +1,53 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class DirReader.
+
+#ifndef DIR_READER_H
+#define DIR_READER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Trees/Trees.h"
+#include "TreeCursor.h"
+
+namespace btrForensics {
+
+    //! Reads entries of a directory in batches, in index order.
+    //!
+    //! Entries are taken from the leaves as the reader advances, so only
+    //! the leaves of the current batch are held and a directory of any
+    //! size is read with constant memory.
+    class DirReader {
+    public:
+        using EntryPtr = std::shared_ptr<const DirItem>; //!< Entry keeping its leaf alive.
+
+    private:
+        TreeCursor cursor;
+        uint64_t dirId; //!< Inode number of the directory being read.
+        bool finished; //!< True if all entries are read.
+        std::shared_ptr<const InodeItem> inode;
+        std::shared_ptr<const InodeRef> ref;
+
+    public:
+        DirReader(const BtrfsPool *pool, const BtrfsNode *rootNode);
+
+        bool open(uint64_t id);
+        bool read(std::vector<EntryPtr> &batch, size_t maxEntries = DEFAULT_BATCH_SIZE);
+
+        //! Return inode number of the directory.
+        uint64_t getDirId() const { return dirId; }
+        //! Return inode of the directory.
+        const std::shared_ptr<const InodeItem>& getInode() const { return inode; }
+        //! Return inode reference pointing to the directory, may be empty.
+        const std::shared_ptr<const InodeRef>& getRef() const { return ref; }
+
+        uint64_t getParentId() const;
+        std::string getName() const;
+
+        static const size_t DEFAULT_BATCH_SIZE = 1024; //!< Entries returned by one read.
+    };
+}
+
+#endif
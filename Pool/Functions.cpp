@@ -16,9 +16,9 @@ namespace btrForensics{
 //!
 void printLeafDir(const LeafNode* leaf, std::ostream &os)
 {
-    for(auto item : leaf->itemList){
-        if(item->getItemType() == ItemType::DIR_INDEX){
-            const DirItem *dir = static_cast<const DirItem*>(item);
+    for(uint32_t i=0; i<leaf->getNumOfItems(); ++i){
+        if(leaf->getItemType(i) == ItemType::DIR_INDEX){
+            const DirItem *dir = static_cast<const DirItem*>(leaf->getItem(i));
             if(dir->type == DirItemType::REGULAR_FILE)
                 os << dir->getDirName() << '\n';
         }
@@ -26,69 +26,42 @@ void printLeafDir(const LeafNode* leaf, std::ostream &os)
 }
 
 
-//! Search for first item with given id and type in a leaf node.
+//! Search for first item with given id and type in a tree.
 //!
-//! \param leaf Pointer to the leaf node.
+//! \param cursor Cursor of the tree, left at the found item.
 //! \param inodeNum The inode number to search for.
 //! \param type The type of the item to search for.
-//! \param[out] item Found ItemHead pointer. Only the first found will be returned.
+//! \param[out] foundItem Found item, which keeps the leaf pinned. Only the first found will be returned.
 //!
 //! \return True if the item is found.
 //!
-bool searchForItem(const LeafNode* leaf, uint64_t inodeNum,
-       ItemType type, const BtrfsItem* &foundItem)
+bool searchForItem(TreeCursor &cursor, uint64_t inodeNum,
+       ItemType type, ItemPtr &foundItem)
 {
-    for(auto item : leaf->itemList) {
-        if(item->getId() > inodeNum) //Items are sorted in leaf nodes by ids.
-            return false;
-        if(item->getId() == inodeNum &&
-                item->getItemType() == type) {
-            foundItem = item;
-            return true;
-        }
+    if(cursor.seek(BtrfsKey(inodeNum, type, 0)) && cursor.getObjId() == inodeNum
+            && cursor.getItemType() == type) {
+        foundItem = cursor.getItem();
+        return true;
     }
     return false;
 }
 
 
-//! Find all items with given id and type in a leaf node.
+//! Find all items with given id and type in a tree.
 //!
-//! \param leaf Pointer to the leaf node.
+//! \param cursor Cursor of the tree.
 //! \param inodeNum The inode number to search for.
 //! \param type The type of the item to search for.
 //! \param[out] vec Vector storing all found items.
 //!
-//! \return True if all items with the inodeNum has been found.
-//!
-bool filterItems(const LeafNode* leaf, uint64_t inodeNum, ItemType type,
-       vector<const BtrfsItem*> &vec)
-{
-    for(auto item : leaf->itemList) {
-        if(item->getId() > inodeNum) //Items are sorted in leaf nodes by ids.
-            return true;
-        if(item->getId() == inodeNum &&
-                item->getItemType() == type) {
-            // Is it possible to find duplicate items?
-            //auto result = find(vec.cbegin(), vec.cend(), item);
-            //if(result == vec.cend())
-                vec.push_back(item);
-        }
-    }
-    return false;
-}
-
-
-//! Find all items with given type in a leaf node.
-//!
-//! \param leaf Pointer to the leaf node.
-//! \param type The type of the item to search for.
-//! \param vec Vector storing all found items.
-//!
-void filterItems(const LeafNode* leaf, ItemType type, vector<const BtrfsItem*> &vec)
+void filterItems(TreeCursor &cursor, uint64_t inodeNum, ItemType type,
+       vector<ItemPtr> &vec)
 {
-    for(auto item : leaf->itemList) {
-        if(item->getItemType() == type)
-            vec.push_back(item);
+    //Items are sorted by keys, so all matches are adjacent.
+    for(bool valid = cursor.seek(BtrfsKey(inodeNum, type, 0)); valid; valid = cursor.next()) {
+        if(cursor.getObjId() != inodeNum || cursor.getItemType() != type)
+            break;
+        vec.push_back(cursor.getItem());
     }
 }
 
@@ -14,11 +14,9 @@ namespace btrForensics{
 
     void printLeafDir(const LeafNode*, std::ostream&);
 
-    bool searchForItem(const LeafNode*, uint64_t, ItemType, const BtrfsItem*&);
+    bool searchForItem(TreeCursor&, uint64_t, ItemType, ItemPtr&);
 
-    bool filterItems(const LeafNode*, uint64_t, ItemType, vector<const BtrfsItem*>&);
-
-    void filterItems(const LeafNode*, ItemType, vector<const BtrfsItem*>&);
+    void filterItems(TreeCursor&, uint64_t, ItemType, vector<ItemPtr>&);
 
     std::ostream &operator<<(std::ostream& os, const DirItemType& type);
 }
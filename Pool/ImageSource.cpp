@@ -0,0 +1,34 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class ImageSource.
+
+#include "ImageSource.h"
+#include "TskImageSource.h"
+#include "MmapImageSource.h"
+
+namespace btrForensics {
+
+//! Choose the backend for an image.
+//!
+//! Single file raw images and block devices are memory mapped,
+//! other formats such as E01 and AFF are read through TSK.
+//!
+//! \param img Image opened by TSK.
+//!
+//! \return The image source, to be deleted by caller.
+//!
+ImageSource* ImageSource::open(TSK_IMG_INFO *img)
+{
+#ifndef TSK_WIN32
+    if(img->itype == TSK_IMG_TYPE_RAW && img->num_img == 1 && img->images != nullptr) {
+        MmapImageSource *source = new MmapImageSource(img->images[0]);
+        if(source->isMapped())
+            return source;
+        delete source;
+    }
+#endif
+    return new TskImageSource(img);
+}
+
+}
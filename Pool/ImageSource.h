@@ -0,0 +1,56 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class ImageSource.
+
+#ifndef IMAGE_SOURCE_H
+#define IMAGE_SOURCE_H
+
+#include <cstddef>
+#include <tsk/libtsk.h>
+
+namespace btrForensics {
+
+    //! Expected access pattern of an image range.
+    enum class AccessHint {
+        RANDOM, //!< Scattered reads, such as tree nodes.
+        SEQUENTIAL, //!< Reads in increasing order, such as file extraction.
+        WILLNEED //!< Range will be read soon.
+    };
+
+
+    //! Read access to the image a pool is stored in.
+    class ImageSource {
+    public:
+        virtual ~ImageSource() = default; //!< Destructor
+
+        //! Read data from the image.
+        //!
+        //! \param offset Offset of data in the image.
+        //! \param[out] data Buffer receiving the data.
+        //! \param size Size of data.
+        //!
+        //! \return Number of bytes read, -1 on error.
+        //!
+        virtual ssize_t read(uint64_t offset, char *data, size_t size) const = 0;
+
+        //! Get a read-only view of image data without copying.
+        //!
+        //! \return Pointer to the data, nullptr if not supported by the backend.
+        //!
+        virtual const char* view(uint64_t offset, size_t size) const { return nullptr; }
+
+        //! Return file descriptor of the image, -1 if there is none.
+        virtual int getFd() const { return -1; }
+
+        //! Hint the expected access pattern of an image range.
+        virtual void advise(uint64_t offset, uint64_t size, AccessHint hint) const {}
+
+        //! Set the number of threads which may read at the same time.
+        virtual void setMaxReaders(unsigned readers) {}
+
+        static ImageSource* open(TSK_IMG_INFO *img);
+    };
+}
+
+#endif
@@ -0,0 +1,59 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class ItemBundle.
+
+#include <algorithm>
+#include "ItemBundle.h"
+#include "TreeCursor.h"
+
+namespace btrForensics {
+
+//! Collect items of an object id with given types.
+//!
+//! Items of other types are skipped without being decoded, and the sweep
+//! stops after the largest wanted type.
+//!
+//! \param cursor Cursor of the tree.
+//! \param objId Object id of the items.
+//! \param types Item types to collect.
+//!
+//! \return True if any item is found.
+//!
+bool ItemBundle::load(TreeCursor &cursor, uint64_t objId,
+        std::initializer_list<ItemType> types)
+{
+    groups.clear();
+    if(types.size() == 0)
+        return false;
+
+    ItemType firstType = std::min(types);
+    ItemType lastType = std::max(types);
+    for(bool valid = cursor.seek(BtrfsKey(objId, firstType, 0)); valid; valid = cursor.next()) {
+        ItemType type = cursor.getItemType();
+        if(cursor.getObjId() != objId || type > lastType)
+            break;
+        if(std::find(types.begin(), types.end(), type) != types.end())
+            groups[type].push_back(cursor.getItem());
+    }
+    return !groups.empty();
+}
+
+
+//! Return all found items of a type.
+const std::vector<ItemPtr>& ItemBundle::getItems(ItemType type) const
+{
+    static const std::vector<ItemPtr> none;
+    auto found = groups.find(type);
+    return found == groups.end() ? none : found->second;
+}
+
+
+//! Return the first found item of a type, empty if there is none.
+ItemPtr ItemBundle::getFirst(ItemType type) const
+{
+    auto found = groups.find(type);
+    return found == groups.end() ? ItemPtr() : found->second.front();
+}
+
+}
@@ -0,0 +1,36 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class ItemBundle.
+
+#ifndef ITEM_BUNDLE_H
+#define ITEM_BUNDLE_H
+
+#include <map>
+#include <vector>
+#include <initializer_list>
+#include "Trees/Trees.h"
+
+namespace btrForensics {
+    class TreeCursor;
+
+    //! Items of one object id, such as an inode, grouped by item type.
+    //!
+    //! Items of an object id are adjacent in a tree, so all of them
+    //! are collected with one seek and one forward sweep.
+    class ItemBundle {
+    private:
+        std::map<ItemType, std::vector<ItemPtr>> groups; //!< Found items by type, in key order.
+
+    public:
+        bool load(TreeCursor &cursor, uint64_t objId, std::initializer_list<ItemType> types);
+
+        const std::vector<ItemPtr>& getItems(ItemType type) const;
+        ItemPtr getFirst(ItemType type) const;
+
+        //! Return true if no item is found.
+        bool empty() const { return groups.empty(); }
+    };
+}
+
+#endif
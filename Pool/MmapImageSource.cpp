@@ -0,0 +1,103 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class MmapImageSource.
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "MmapImageSource.h"
+
+namespace btrForensics {
+
+//! Constructor of MmapImageSource.
+//!
+//! Mapping failure is not an error, check isMapped() and fall back to TSK.
+//!
+//! \param path Path of the raw image or block device.
+//!
+MmapImageSource::MmapImageSource(const TSK_TCHAR *path)
+    :fd(-1), base(nullptr), mapSize(0)
+{
+    fd = ::open(path, O_RDONLY);
+    if(fd < 0)
+        return;
+
+    //Works for both regular files and block devices.
+    off_t size = lseek(fd, 0, SEEK_END);
+    if(size <= 0)
+        return;
+
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if(addr == MAP_FAILED)
+        return;
+
+    base = static_cast<char*>(addr);
+    mapSize = size;
+    //Most reads are tree nodes scattered over the image.
+    madvise(base, mapSize, MADV_RANDOM);
+}
+
+
+//! Destructor
+MmapImageSource::~MmapImageSource()
+{
+    if(base != nullptr)
+        munmap(base, mapSize);
+    if(fd >= 0)
+        close(fd);
+}
+
+
+//! Copy data from the mapping.
+ssize_t MmapImageSource::read(uint64_t offset, char *data, size_t size) const
+{
+    if(offset >= mapSize)
+        return -1;
+    if(size > mapSize - offset)
+        size = mapSize - offset;
+
+    memcpy(data, base + offset, size);
+    return size;
+}
+
+
+//! Return pointer into the mapping, nullptr if range is out of the image.
+const char* MmapImageSource::view(uint64_t offset, size_t size) const
+{
+    if(offset >= mapSize || size > mapSize - offset)
+        return nullptr;
+    return base + offset;
+}
+
+
+//! Pass access pattern of a range to the kernel.
+void MmapImageSource::advise(uint64_t offset, uint64_t size, AccessHint hint) const
+{
+    if(offset >= mapSize)
+        return;
+    if(size > mapSize - offset)
+        size = mapSize - offset;
+
+    //madvise needs a page aligned address.
+    uint64_t pageSize = sysconf(_SC_PAGESIZE);
+    uint64_t start = offset - offset % pageSize;
+    size += offset - start;
+
+    int advice(MADV_NORMAL);
+    switch(hint) {
+        case AccessHint::RANDOM:
+            advice = MADV_RANDOM;
+            break;
+        case AccessHint::SEQUENTIAL:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case AccessHint::WILLNEED:
+            advice = MADV_WILLNEED;
+            break;
+    }
+    madvise(base + start, size, advice);
+}
+
+}
@@ -0,0 +1,36 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class MmapImageSource.
+
+#ifndef MMAP_IMAGE_SOURCE_H
+#define MMAP_IMAGE_SOURCE_H
+
+#include "ImageSource.h"
+
+namespace btrForensics {
+
+    //! Raw image or block device mapped into memory.
+    class MmapImageSource : public ImageSource {
+    private:
+        int fd; //!< File descriptor of the image, -1 if not opened.
+        char *base; //!< Start of the mapping, nullptr if not mapped.
+        uint64_t mapSize; //!< Size of the mapping in bytes.
+
+    public:
+        MmapImageSource(const TSK_TCHAR *path);
+        ~MmapImageSource();
+
+        //! Return true if the image is mapped.
+        bool isMapped() const { return base != nullptr; }
+
+        //! Return file descriptor of the image.
+        int getFd() const override { return fd; }
+
+        ssize_t read(uint64_t offset, char *data, size_t size) const override;
+        const char* view(uint64_t offset, size_t size) const override;
+        void advise(uint64_t offset, uint64_t size, AccessHint hint) const override;
+    };
+}
+
+#endif
@@ -0,0 +1,113 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class NodeCache.
+
+#include "NodeCache.h"
+
+namespace btrForensics {
+
+//! Constructor of node cache.
+//!
+//! \param budgetBytes Maximum bytes of unpinned nodes to keep.
+//!
+NodeCache::NodeCache(uint64_t budgetBytes)
+    :budget(budgetBytes), usedBytes(0)
+{
+}
+
+
+//! Find a cached node and mark it as recently used.
+//!
+//! \param logicalAddr Logical address of the node.
+//!
+//! \return The node, or an empty pointer if not cached.
+//!
+NodePtr NodeCache::find(uint64_t logicalAddr)
+{
+    std::lock_guard<std::mutex> guard(cacheLock);
+    auto found = entries.find(logicalAddr);
+    if(found == entries.end())
+        return NodePtr();
+
+    lruList.splice(lruList.begin(), lruList, found->second);
+    return found->second->node;
+}
+
+
+//! Check whether a node is cached, without marking it as used.
+//!
+//! \param logicalAddr Logical address of the node.
+//!
+//! \return True if the node is cached.
+//!
+bool NodeCache::contains(uint64_t logicalAddr)
+{
+    std::lock_guard<std::mutex> guard(cacheLock);
+    return entries.find(logicalAddr) != entries.end();
+}
+
+
+//! Add a node to the cache, evicting old ones if over budget.
+//!
+//! \param logicalAddr Logical address of the node.
+//! \param node The parsed node.
+//! \param charge Bytes charged against the budget for this node.
+//!
+void NodeCache::insert(uint64_t logicalAddr, NodePtr node, uint64_t charge)
+{
+    std::lock_guard<std::mutex> guard(cacheLock);
+    auto found = entries.find(logicalAddr);
+    if(found != entries.end()) {
+        usedBytes -= found->second->charge;
+        lruList.erase(found->second);
+        entries.erase(found);
+    }
+
+    lruList.push_front(Entry{logicalAddr, node, charge});
+    entries[logicalAddr] = lruList.begin();
+    usedBytes += charge;
+
+    evict();
+}
+
+
+//! Drop all cached nodes. Pinned nodes stay alive with their holders.
+void NodeCache::clear()
+{
+    std::lock_guard<std::mutex> guard(cacheLock);
+    entries.clear();
+    lruList.clear();
+    usedBytes = 0;
+}
+
+
+//! Change the byte budget of the cache.
+//!
+//! \param budgetBytes Maximum bytes of unpinned nodes to keep.
+//!
+void NodeCache::setBudget(uint64_t budgetBytes)
+{
+    std::lock_guard<std::mutex> guard(cacheLock);
+    budget = budgetBytes;
+    evict();
+}
+
+
+//! Evict least recently used nodes that are not pinned until within budget.
+//! Caller must hold the cache lock.
+void NodeCache::evict()
+{
+    auto iter = lruList.end();
+    while(usedBytes > budget && iter != lruList.begin()) {
+        --iter;
+        //Only the cache itself holds the node, it is not in use.
+        if(iter->node.use_count() == 1) {
+            usedBytes -= iter->charge;
+            entries.erase(iter->logicalAddr);
+            iter = lruList.erase(iter);
+        }
+    }
+}
+
+}
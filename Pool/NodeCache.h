@@ -0,0 +1,64 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class NodeCache.
+
+#ifndef NODE_CACHE_H
+#define NODE_CACHE_H
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include "Trees/BtrfsNode.h"
+
+namespace btrForensics {
+
+    //! Bounded cache of parsed nodes, keyed by logical address.
+    //!
+    //! Nodes are shared by all trees of a pool, so blocks shared by
+    //! snapshots are parsed only once. Least recently used nodes are
+    //! evicted when the byte budget is exceeded. A node is pinned as long
+    //! as a NodePtr or ItemPtr to it is held outside the cache, and pinned
+    //! nodes are never evicted. All operations are serialized by a lock,
+    //! so the cache can be shared by threads walking trees in parallel.
+    class NodeCache {
+    private:
+        //! Cached node with its logical address and charged size.
+        struct Entry {
+            uint64_t logicalAddr;
+            NodePtr node;
+            uint64_t charge;
+        };
+
+        std::list<Entry> lruList; //!< Most recently used entry at the front.
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> entries;
+
+        uint64_t budget; //!< Maximum bytes of unpinned nodes kept.
+        uint64_t usedBytes; //!< Bytes charged by all cached nodes.
+        std::mutex cacheLock; //!< Guards all members above.
+
+    public:
+        NodeCache(uint64_t budgetBytes = DEFAULT_BUDGET);
+        ~NodeCache() = default; //!< Destructor
+
+        NodePtr find(uint64_t logicalAddr);
+        bool contains(uint64_t logicalAddr);
+        void insert(uint64_t logicalAddr, NodePtr node, uint64_t charge);
+        void clear();
+
+        void setBudget(uint64_t budgetBytes);
+        //! Return the byte budget of the cache.
+        uint64_t getBudget() const { return budget; }
+        //! Return bytes charged by cached nodes.
+        uint64_t getUsedBytes() const { return usedBytes; }
+        //! Return number of cached nodes.
+        size_t size() const { return entries.size(); }
+
+        static const uint64_t DEFAULT_BUDGET = 64 * 1024 * 1024; //!< Default budget in bytes.
+
+    private:
+        void evict();
+    };
+}
+
+#endif
@@ -0,0 +1,173 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class NodePrefetcher.
+
+#include "NodePrefetcher.h"
+#include "BtrfsPool.h"
+
+namespace btrForensics {
+
+//! Constructor of node prefetcher, starting the worker thread.
+//!
+//! \param pool Pool the nodes belong to.
+//! \param budget Maximum bytes of nodes held.
+//! \param queueDepth Number of nodes read in one batch.
+//!
+NodePrefetcher::NodePrefetcher(const BtrfsPool *pool, uint64_t budget, unsigned queueDepth)
+    :btrPool(pool), engine(pool->imgSource, queueDepth),
+     maxSlots(budget / pool->primarySupblk->nodeSize), stopping(false)
+{
+    worker = std::thread(&NodePrefetcher::run, this);
+}
+
+
+//! Destructor, waits for the worker thread to finish.
+NodePrefetcher::~NodePrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> guard(slotLock);
+        stopping = true;
+    }
+    slotCond.notify_all();
+    worker.join();
+}
+
+
+//! Queue nodes to be read in background.
+//!
+//! Nodes already cached or queued are skipped. Requests stop
+//! when the budget is used up by nodes not yet taken.
+//!
+//! \param logicalAddrs Logical addresses of the nodes, in the order they will be visited.
+//!
+void NodePrefetcher::request(const std::vector<uint64_t> &logicalAddrs)
+{
+    bool queued(false);
+    {
+        std::lock_guard<std::mutex> guard(slotLock);
+        for(auto addr : logicalAddrs) {
+            if(slots.find(addr) != slots.end()
+                    || btrPool->nodeCache.contains(addr))
+                continue;
+            if(!makeRoom())
+                break;
+
+            slots[addr] = Slot{NodePtr(), false, 0};
+            queue.push_back(addr);
+            order.push_back(addr);
+            queued = true;
+        }
+    }
+    if(queued)
+        slotCond.notify_all();
+}
+
+
+//! Take a prefetched node, waiting for it if it is being read.
+//!
+//! \param logicalAddr Logical address of the node.
+//!
+//! \return The node, empty if it was not requested or could not be read.
+//!
+NodePtr NodePrefetcher::take(uint64_t logicalAddr)
+{
+    std::unique_lock<std::mutex> guard(slotLock);
+    auto found = slots.find(logicalAddr);
+    if(found == slots.end())
+        return NodePtr();
+
+    //Other threads may add or take slots while waiting, so the slot
+    //is looked up again by address instead of holding an iterator.
+    ++found->second.waiters;
+    slotCond.wait(guard, [this, logicalAddr] {
+        auto slot = slots.find(logicalAddr);
+        return slot == slots.end() || slot->second.done;
+    });
+    found = slots.find(logicalAddr);
+    if(found == slots.end()) //Taken by another thread.
+        return NodePtr();
+
+    NodePtr node = found->second.node;
+    slots.erase(found);
+    return node;
+}
+
+
+//! Drop oldest finished nodes until a new one fits in the budget.
+//!
+//! \return False if the budget is used up by nodes still being read or waited for.
+//!
+bool NodePrefetcher::makeRoom()
+{
+    while(slots.size() >= maxSlots && !order.empty()) {
+        auto oldest = slots.find(order.front());
+        if(oldest == slots.end()) { //Taken already.
+            order.pop_front();
+            continue;
+        }
+        if(!oldest->second.done || oldest->second.waiters > 0)
+            return false;
+        slots.erase(oldest);
+        order.pop_front();
+    }
+    return slots.size() < maxSlots;
+}
+
+
+//! Loop of the worker thread, reading queued nodes in batches.
+void NodePrefetcher::run()
+{
+    uint32_t nodeSize = btrPool->primarySupblk->nodeSize;
+    char *nodesArr = new char[engine.getQueueDepth() * nodeSize];
+
+    while(true) {
+        std::vector<uint64_t> batch;
+        {
+            std::unique_lock<std::mutex> guard(slotLock);
+            slotCond.wait(guard, [this] { return stopping || !queue.empty(); });
+            if(stopping)
+                break;
+            while(!queue.empty() && batch.size() < engine.getQueueDepth()) {
+                batch.push_back(queue.front());
+                queue.pop_front();
+            }
+        }
+
+        std::vector<ReadRequest> requests;
+        for(size_t i=0; i<batch.size(); ++i)
+            requests.push_back(ReadRequest{batch[i], nodesArr + i * nodeSize, nodeSize});
+
+        std::vector<NodePtr> nodes(batch.size());
+        try {
+            engine.read(btrPool->mapRequests(requests));
+            for(size_t i=0; i<batch.size(); ++i) {
+                uint64_t physicalAddr, length;
+                btrPool->chunkMap.mapAddress(batch[i], physicalAddr, length);
+                try {
+                    nodes[i] = NodePtr(btrPool->buildNode(requests[i].data, physicalAddr));
+                } catch(FsDamagedException &e) {
+                    //Left empty, the walk reads it again and reports the error.
+                }
+            }
+        } catch(std::exception &e) {
+            //Unmapped address, the walk reads it again and reports the error.
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(slotLock);
+            for(size_t i=0; i<batch.size(); ++i) {
+                auto found = slots.find(batch[i]);
+                if(found == slots.end())
+                    continue;
+                found->second.node = nodes[i];
+                found->second.done = true;
+            }
+        }
+        slotCond.notify_all();
+    }
+
+    delete [] nodesArr;
+}
+
+}
@@ -0,0 +1,61 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class NodePrefetcher.
+
+#ifndef NODE_PREFETCHER_H
+#define NODE_PREFETCHER_H
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include "ReadEngine.h"
+#include "Trees/BtrfsNode.h"
+
+namespace btrForensics {
+    class BtrfsPool;
+
+    //! Read and parse nodes in background before a tree walk reaches them.
+    //!
+    //! A worker thread reads queued nodes in batches of queue depth.
+    //! At most budget bytes of nodes are queued or waiting to be taken,
+    //! oldest finished ones are dropped to make room for new requests.
+    class NodePrefetcher {
+    private:
+        //! Node being prefetched.
+        struct Slot {
+            NodePtr node; //!< Parsed node, empty if reading failed.
+            bool done; //!< True when reading is finished.
+            unsigned waiters; //!< Threads waiting in take(), the slot is not dropped while non-zero.
+        };
+
+        const BtrfsPool *btrPool;
+        ReadEngine engine; //!< Reads of the worker thread.
+        size_t maxSlots; //!< Maximum number of nodes held.
+
+        std::unordered_map<uint64_t, Slot> slots;
+        std::deque<uint64_t> queue; //!< Nodes waiting to be read.
+        std::deque<uint64_t> order; //!< Requested nodes, oldest first.
+        bool stopping;
+
+        std::mutex slotLock;
+        std::condition_variable slotCond;
+        std::thread worker;
+
+    public:
+        NodePrefetcher(const BtrfsPool *pool, uint64_t budget, unsigned queueDepth);
+        ~NodePrefetcher();
+
+        void request(const std::vector<uint64_t> &logicalAddrs);
+        NodePtr take(uint64_t logicalAddr);
+
+    private:
+        bool makeRoom();
+        void run();
+    };
+}
+
+#endif
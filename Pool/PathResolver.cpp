@@ -0,0 +1,177 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class PathResolver.
+
+#include <vector>
+#include <unordered_set>
+#include "PathResolver.h"
+#include "TreeCursor.h"
+
+namespace btrForensics {
+
+const std::string PathResolver::ORPHAN_DIR("/$OrphanFiles/");
+const std::string PathResolver::UNRESOLVED_DIR("$UnresolvedPath");
+
+
+//! Constructor of PathResolver.
+//!
+//! \param pool Pool the resolved trees belong to.
+//!
+PathResolver::PathResolver(const BtrfsPool *pool)
+    :btrPool(pool)
+{
+}
+
+
+//! Find inode ref of an inode, which holds its name and parent directory.
+//!
+//! \return True if the inode ref is found.
+//!
+static bool findInodeRef(TreeCursor &cursor, uint64_t inodeNum, std::string &name, uint64_t &parent)
+{
+    if(!cursor.seek(BtrfsKey(inodeNum, ItemType::INODE_REF, 0)) || cursor.getObjId() != inodeNum
+            || cursor.getItemType() != ItemType::INODE_REF)
+        return false;
+    ItemPtr item = cursor.getItem();
+    name = static_cast<const InodeRef*>(item.get())->getDirName();
+    parent = cursor.getKey().offset;
+    return true;
+}
+
+
+//! Return full path of a directory.
+//!
+//! Inode refs are followed up to the root directory or a directory whose
+//! path is known, paths of all directories on the way are remembered.
+//! A directory without inode ref is placed under ORPHAN_DIR. A directory
+//! met twice on the way, which only happens in a damaged tree, is shown
+//! as UNRESOLVED_DIR under the root.
+//!
+//! \param tree Filesystem tree of the directory.
+//! \param dirId Inode number of the directory.
+//!
+//! \return Path of the directory.
+//!
+PathResolver::PrefixPtr PathResolver::getDirPath(const FilesystemTree *tree, uint64_t dirId)
+{
+    TreeCursor cursor(btrPool, tree->fileTreeRoot.get());
+    std::vector<std::pair<uint64_t, std::string>> chain; //Directories to be added, child first.
+    std::unordered_set<uint64_t> visited;
+    PrefixPtr prefix;
+    uint64_t current(dirId);
+    while(true) {
+        {
+            std::lock_guard<std::mutex> guard(pathLock);
+            auto found = dirPaths.find(std::make_pair(tree->fsId, current));
+            if(found != dirPaths.end()) {
+                prefix = found->second;
+                break;
+            }
+        }
+
+        std::string name;
+        uint64_t parent;
+        if(current == tree->rootDirId)
+            prefix = std::make_shared<const PathNode>(PathNode{nullptr, ""});
+        else if(chain.size() == MAX_PATH_DEPTH || !visited.insert(current).second)
+            prefix = std::make_shared<const PathNode>(PathNode{nullptr, UNRESOLVED_DIR});
+        else if(!findInodeRef(cursor, current, name, parent))
+            prefix = std::make_shared<const PathNode>(PathNode{nullptr,
+                    ORPHAN_DIR.substr(1) + "OrphanFile-" + std::to_string(current)});
+        else {
+            chain.push_back(std::make_pair(current, name));
+            current = parent;
+            continue;
+        }
+
+        std::lock_guard<std::mutex> guard(pathLock);
+        prefix = dirPaths.insert(std::make_pair(std::make_pair(tree->fsId, current), prefix)).first->second;
+        break;
+    }
+
+    for(auto it = chain.rbegin(); it != chain.rend(); ++it)
+        prefix = addDir(tree, it->first, prefix, it->second);
+    return prefix;
+}
+
+
+//! Remember path of a directory whose parent is known.
+//!
+//! \param tree Filesystem tree of the directory.
+//! \param dirId Inode number of the directory.
+//! \param parent Path of parent directory.
+//! \param name Name of the directory.
+//!
+//! \return Path of the directory.
+//!
+PathResolver::PrefixPtr PathResolver::addDir(const FilesystemTree *tree, uint64_t dirId,
+        const PrefixPtr &parent, const std::string &name)
+{
+    auto key = std::make_pair(tree->fsId, dirId);
+    {
+        std::lock_guard<std::mutex> guard(pathLock);
+        auto found = dirPaths.find(key);
+        if(found != dirPaths.end())
+            return found->second;
+    }
+    PrefixPtr prefix = std::make_shared<const PathNode>(PathNode{parent, name});
+    std::lock_guard<std::mutex> guard(pathLock);
+    return dirPaths.insert(std::make_pair(key, prefix)).first->second;
+}
+
+
+//! Return full path of an inode.
+//!
+//! \param tree Filesystem tree of the inode.
+//! \param inodeNum Inode number.
+//!
+std::string PathResolver::getPath(const FilesystemTree *tree, uint64_t inodeNum)
+{
+    if(inodeNum == tree->rootDirId)
+        return "/";
+
+    TreeCursor cursor(btrPool, tree->fileTreeRoot.get());
+    std::string name;
+    uint64_t parent;
+    if(!findInodeRef(cursor, inodeNum, name, parent))
+        return ORPHAN_DIR + "OrphanFile-" + std::to_string(inodeNum);
+    return toString(getDirPath(tree, parent)) + name;
+}
+
+
+//! Build the text of a directory path.
+//!
+//! \param prefix Path of the directory.
+//!
+//! \return Path of the directory ending with '/'.
+//!
+std::string PathResolver::toString(const PrefixPtr &prefix)
+{
+    std::vector<const PathNode*> nodes; //Directories of the path, deepest first.
+    size_t length(1);
+    for(const PathNode *node = prefix.get(); node != nullptr; node = node->parent.get()) {
+        nodes.push_back(node);
+        length += node->name.size() + 1;
+    }
+
+    std::string path("/");
+    path.reserve(length);
+    for(auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+        if((*it)->name.empty())
+            continue; //The root directory.
+        path += (*it)->name;
+        path += '/';
+    }
+    return path;
+}
+
+
+//! Forget all remembered paths.
+void PathResolver::clear()
+{
+    std::lock_guard<std::mutex> guard(pathLock);
+    dirPaths.clear();
+}
+
+}
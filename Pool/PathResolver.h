@@ -0,0 +1,62 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class PathResolver.
+
+#ifndef PATH_RESOLVER_H
+#define PATH_RESOLVER_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "Trees/Trees.h"
+
+namespace btrForensics {
+    class BtrfsPool;
+
+    //! Builds full paths of inodes, remembering paths of directories.
+    //!
+    //! Each directory is kept as its name and a link to its parent, so
+    //! shared prefixes are stored once and paths of all entries in a
+    //! directory cost one lookup of their parent.
+    class PathResolver {
+    public:
+        //! Directory in a path, the root when parent is empty and name is empty.
+        struct PathNode {
+            std::shared_ptr<const PathNode> parent; //!< Parent directory, empty under the root.
+            std::string name; //!< Name of the directory.
+        };
+        using PrefixPtr = std::shared_ptr<const PathNode>; //!< Path of a directory.
+
+    private:
+        //! Hash of subvolume id and inode number.
+        struct KeyHash {
+            size_t operator()(const std::pair<uint64_t, uint64_t> &key) const {
+                return std::hash<uint64_t>()(key.first * 0x9E3779B97F4A7C15ULL ^ key.second);
+            }
+        };
+
+        const BtrfsPool *btrPool;
+        std::mutex pathLock; //!< Guards dirPaths.
+        std::unordered_map<std::pair<uint64_t, uint64_t>, PrefixPtr, KeyHash> dirPaths; //!< Paths by subvolume id and inode.
+
+    public:
+        PathResolver(const BtrfsPool *pool);
+
+        PrefixPtr getDirPath(const FilesystemTree *tree, uint64_t dirId);
+        PrefixPtr addDir(const FilesystemTree *tree, uint64_t dirId,
+                const PrefixPtr &parent, const std::string &name);
+        std::string getPath(const FilesystemTree *tree, uint64_t inodeNum);
+        void clear();
+
+        static std::string toString(const PrefixPtr &prefix);
+
+        static const size_t MAX_PATH_DEPTH = 4096; //!< Deeper paths are taken as loops in a damaged tree.
+        static const std::string ORPHAN_DIR; //!< Parent of inodes whose path is lost.
+        static const std::string UNRESOLVED_DIR; //!< Name of directories whose path loops in a damaged tree.
+    };
+}
+
+#endif
@@ -7,6 +7,16 @@
 #include "Trees/Trees.h"
 
 #include "DeviceRecord.h"
+#include "ChunkMap.h"
+#include "ImageSource.h"
+#include "ReadEngine.h"
+#include "NodeCache.h"
+#include "NodePrefetcher.h"
+#include "TreeCursor.h"
+#include "TaskQueues.h"
+#include "ItemBundle.h"
+#include "DirReader.h"
+#include "PathResolver.h"
 //#include "TreeExaminer.h"
 #include "Functions.h"
 #include "BtrfsPool.h"
@@ -0,0 +1,238 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class ReadEngine.
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include "ReadEngine.h"
+#include "Basics/Exceptions.h"
+
+#ifdef HAVE_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+namespace btrForensics {
+
+#ifdef HAVE_IO_URING
+
+//! Mapped rings of an io_uring instance, set up with raw system calls.
+struct ReadEngine::Ring {
+    int fd;
+    unsigned entries;
+
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    io_uring_sqe *sqes;
+    size_t sqesSize;
+
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    io_uring_cqe *cqes;
+};
+
+
+//! Create an io_uring instance.
+//!
+//! \return The ring, nullptr if io_uring is not available.
+//!
+ReadEngine::Ring* ReadEngine::setupRing(unsigned entries)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = syscall(__NR_io_uring_setup, entries, &params);
+    if(fd < 0)
+        return nullptr;
+
+    Ring *ring = new Ring();
+    ring->fd = fd;
+    ring->entries = params.sq_entries;
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if(singleMmap && ring->cqRingSize > ring->sqRingSize)
+        ring->sqRingSize = ring->cqRingSize;
+
+    ring->sqRing = mmap(nullptr, ring->sqRingSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if(singleMmap)
+        ring->cqRing = ring->sqRing;
+    else
+        ring->cqRing = mmap(nullptr, ring->cqRingSize, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    void *sqes = mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+
+    if(ring->sqRing == MAP_FAILED || ring->cqRing == MAP_FAILED || sqes == MAP_FAILED) {
+        if(sqes != MAP_FAILED)
+            munmap(sqes, ring->sqesSize);
+        if(!singleMmap && ring->cqRing != MAP_FAILED)
+            munmap(ring->cqRing, ring->cqRingSize);
+        if(ring->sqRing != MAP_FAILED)
+            munmap(ring->sqRing, ring->sqRingSize);
+        close(fd);
+        delete ring;
+        return nullptr;
+    }
+
+    char *sq = static_cast<char*>(ring->sqRing);
+    char *cq = static_cast<char*>(ring->cqRing);
+    ring->sqes = static_cast<io_uring_sqe*>(sqes);
+    ring->sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    return ring;
+}
+
+
+//! Unmap and close an io_uring instance.
+void ReadEngine::destroyRing(Ring *ring)
+{
+    munmap(ring->sqes, ring->sqesSize);
+    if(ring->cqRing != ring->sqRing)
+        munmap(ring->cqRing, ring->cqRingSize);
+    munmap(ring->sqRing, ring->sqRingSize);
+    close(ring->fd);
+    delete ring;
+}
+
+#else
+
+struct ReadEngine::Ring {
+};
+
+#endif
+
+
+//! Constructor of ReadEngine.
+//!
+//! \param src Image the reads are served from.
+//! \param depth Maximum number of reads in flight.
+//!
+ReadEngine::ReadEngine(const ImageSource *src, unsigned depth)
+    :source(src), queueDepth(0), ring(nullptr)
+{
+    setQueueDepth(depth);
+}
+
+
+//! Destructor
+ReadEngine::~ReadEngine()
+{
+#ifdef HAVE_IO_URING
+    if(ring != nullptr)
+        destroyRing(ring);
+#endif
+}
+
+
+//! Set maximum number of reads in flight, recreating the ring.
+//!
+//! \param depth Queue depth, 1 disables asynchronous reads.
+//!
+void ReadEngine::setQueueDepth(unsigned depth)
+{
+    if(depth == 0)
+        depth = 1;
+    if(depth > MAX_QUEUE_DEPTH)
+        depth = MAX_QUEUE_DEPTH;
+    queueDepth = depth;
+
+#ifdef HAVE_IO_URING
+    if(ring != nullptr) {
+        destroyRing(ring);
+        ring = nullptr;
+    }
+    if(depth > 1 && source->getFd() >= 0)
+        ring = setupRing(depth);
+#endif
+}
+
+
+//! Read all requests of a batch, returning when every read is done.
+//!
+//! \param requests Reads to perform, offsets are physical addresses.
+//!
+void ReadEngine::read(const std::vector<ReadRequest> &requests) const
+{
+#ifdef HAVE_IO_URING
+    if(ring != nullptr && requests.size() > 1) {
+        int fd = source->getFd();
+        size_t next(0);
+        unsigned inFlight(0);
+        unsigned unsubmitted(0); //Entries in the ring not taken by the kernel yet.
+        while(next < requests.size() || inFlight > 0 || unsubmitted > 0) {
+            unsigned tail = *ring->sqTail;
+            unsigned queued(0);
+            while(next < requests.size() && inFlight + unsubmitted + queued < ring->entries) {
+                const ReadRequest &req = requests[next];
+                unsigned index = tail & *ring->sqMask;
+                io_uring_sqe *sqe = &ring->sqes[index];
+                memset(sqe, 0, sizeof(*sqe));
+                sqe->opcode = IORING_OP_READ;
+                sqe->fd = fd;
+                sqe->off = req.offset;
+                sqe->addr = reinterpret_cast<uint64_t>(req.data);
+                sqe->len = req.size;
+                sqe->user_data = next;
+                ring->sqArray[index] = index;
+                ++tail;
+                ++queued;
+                ++next;
+            }
+            __atomic_store_n(ring->sqTail, tail, __ATOMIC_RELEASE);
+
+            //The kernel may take fewer entries than offered, the rest are
+            //offered again. Completions are only waited for when some
+            //reads are in flight already.
+            unsigned toSubmit = unsubmitted + queued;
+            int ret;
+            do {
+                ret = syscall(__NR_io_uring_enter, ring->fd, toSubmit, inFlight > 0 ? 1 : 0,
+                        IORING_ENTER_GETEVENTS, nullptr, 0);
+            } while(ret < 0 && errno == EINTR);
+            if(ret < 0 && (errno == EAGAIN || errno == EBUSY) && inFlight > 0)
+                ret = 0; //Retried once completions are taken.
+            else if(ret < 0 || (ret == 0 && toSubmit > 0 && inFlight == 0))
+                throw FsDeviceException("Failed to submit image reads.");
+            inFlight += ret;
+            unsubmitted = toSubmit - ret;
+
+            unsigned head = *ring->cqHead;
+            unsigned cqTail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+            for(; head != cqTail; ++head) {
+                const io_uring_cqe &cqe = ring->cqes[head & *ring->cqMask];
+                const ReadRequest &req = requests[cqe.user_data];
+                //Finish short or failed reads synchronously.
+                size_t done = cqe.res > 0 ? cqe.res : 0;
+                if(done < req.size)
+                    source->read(req.offset + done, req.data + done, req.size - done);
+                --inFlight;
+            }
+            __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+        }
+        return;
+    }
+#endif
+
+    for(const auto &req : requests)
+        source->read(req.offset, req.data, req.size);
+}
+
+}
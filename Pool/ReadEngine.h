@@ -0,0 +1,57 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class ReadEngine.
+
+#ifndef READ_ENGINE_H
+#define READ_ENGINE_H
+
+#include <vector>
+#include <atomic>
+#include "ImageSource.h"
+
+namespace btrForensics {
+
+    //! One read of a batch.
+    class ReadRequest {
+    public:
+        uint64_t offset; //!< Offset of data in the image.
+        char *data; //!< Buffer receiving the data.
+        size_t size; //!< Size of data.
+    };
+
+
+    //! Submit batches of image reads, asynchronously with io_uring when possible.
+    //!
+    //! Reads of a batch complete out of order, up to queue depth of them
+    //! in flight at once. Images without a file descriptor, or kernels
+    //! without io_uring, are read synchronously.
+    class ReadEngine {
+    private:
+        struct Ring;
+
+        const ImageSource *source; //!< Image the reads are served from.
+        std::atomic<unsigned> queueDepth; //!< Maximum number of reads in flight, read without the engine lock.
+        Ring *ring; //!< io_uring instance, nullptr if reads are synchronous.
+
+        static Ring* setupRing(unsigned entries);
+        static void destroyRing(Ring *ring);
+
+    public:
+        ReadEngine(const ImageSource *src, unsigned depth = DEFAULT_QUEUE_DEPTH);
+        ~ReadEngine();
+
+        void read(const std::vector<ReadRequest> &requests) const;
+
+        void setQueueDepth(unsigned depth);
+        //! Return maximum number of reads in flight.
+        unsigned getQueueDepth() const { return queueDepth; }
+        //! Return true if reads are submitted with io_uring.
+        bool isAsync() const { return ring != nullptr; }
+
+        static const unsigned DEFAULT_QUEUE_DEPTH = 32; //!< Default queue depth.
+        static const unsigned MAX_QUEUE_DEPTH = 4096; //!< Largest queue depth accepted.
+    };
+}
+
+#endif
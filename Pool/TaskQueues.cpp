@@ -0,0 +1,58 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class TaskQueues.
+
+#include "TaskQueues.h"
+
+namespace btrForensics {
+
+//! Constructor, splitting tasks 0 to taskNum-1 evenly among workers.
+//!
+//! \param workers Number of workers.
+//! \param taskNum Number of tasks.
+//!
+TaskQueues::TaskQueues(unsigned workers, size_t taskNum)
+    :queues(workers)
+{
+    for(unsigned w=0; w<workers; ++w) {
+        size_t begin = taskNum * w / workers;
+        size_t end = taskNum * (w + 1) / workers;
+        for(size_t task=begin; task<end; ++task)
+            queues[w].tasks.push_back(task);
+    }
+}
+
+
+//! Get next task of a worker, stealing from other workers if needed.
+//!
+//! \param worker Index of the worker.
+//! \param[out] task The task to run.
+//!
+//! \return False if no task is left in any queue.
+//!
+bool TaskQueues::pop(unsigned worker, size_t &task)
+{
+    {
+        Queue &own = queues[worker];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if(!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    for(size_t i=1; i<queues.size(); ++i) {
+        Queue &victim = queues[(worker + i) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if(!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,38 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class TaskQueues.
+
+#ifndef TASK_QUEUES_H
+#define TASK_QUEUES_H
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace btrForensics {
+
+    //! Work-stealing queues distributing numbered tasks among workers.
+    //!
+    //! Each worker starts with a contiguous range of tasks and takes them
+    //! from the front in order. A worker out of tasks steals from the back
+    //! of another queue, so neighbouring tasks tend to stay on one thread.
+    class TaskQueues {
+    private:
+        //! Tasks owned by one worker.
+        struct Queue {
+            std::mutex lock;
+            std::deque<size_t> tasks;
+        };
+
+        std::vector<Queue> queues;
+
+    public:
+        TaskQueues(unsigned workers, size_t taskNum);
+
+        bool pop(unsigned worker, size_t &task);
+    };
+}
+
+#endif
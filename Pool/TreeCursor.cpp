@@ -0,0 +1,192 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class TreeCursor.
+
+#include "TreeCursor.h"
+#include "BtrfsPool.h"
+
+namespace btrForensics {
+
+//! Check a step from an internal node down to one of its children.
+//!
+//! \param depth Number of internal nodes on the path, the parent included.
+//! \param parent The internal node.
+//! \param child Child node read from a key pointer of the parent.
+//!
+static void checkDescent(size_t depth, const BtrfsNode *parent, const BtrfsNode *child)
+{
+    if(depth > BtrfsPool::MAX_TREE_LEVEL)
+        throw FsDamagedException("Tree has more levels than btrfs allows.");
+    if(child->nodeHeader->getLevel() + 1 != parent->nodeHeader->getLevel())
+        throw FsDamagedException("Child node is not one level below its parent.");
+}
+
+
+//! Constructor of tree cursor. The cursor is not valid until seek is called.
+//!
+//! \param pool Pool the tree belongs to.
+//! \param rootNode Root node of the tree.
+//!
+TreeCursor::TreeCursor(const BtrfsPool *pool, const BtrfsNode *rootNode)
+    :btrPool(pool), root(rootNode->shared_from_this()), slot(0) {}
+
+
+//! Move to the first item of the tree.
+//!
+//! \return True if the tree has any item.
+//!
+bool TreeCursor::first()
+{
+    path.clear();
+    leafNode.reset();
+    return descendEdge(root, true) || stepLeaf(true);
+}
+
+
+//! Move to the first item whose key is not less than the given key.
+//!
+//! \param key Key to search for.
+//!
+//! \return True if such an item exists.
+//!
+bool TreeCursor::seek(const BtrfsKey &key)
+{
+    path.clear();
+    leafNode.reset();
+
+    NodePtr node = root;
+    while(!node->nodeHeader->isLeafNode()) {
+        const InternalNode *internal = static_cast<const InternalNode*>(node.get());
+        if(internal->keyPointers.empty())
+            return stepLeaf(true);
+
+        size_t index = internal->findChild(key);
+        path.push_back(Level{node, index});
+        node = btrPool->getNode(internal->keyPointers[index]->getBlkNum());
+        if(node == nullptr)
+            return stepLeaf(true);
+        checkDescent(path.size(), internal, node.get());
+    }
+
+    const LeafNode *leaf = static_cast<const LeafNode*>(node.get());
+    uint32_t index = leaf->lowerBound(key);
+    if(index == leaf->getNumOfItems())
+        return stepLeaf(true); //All keys of following leaves are larger.
+
+    leafNode = node;
+    slot = index;
+    return true;
+}
+
+
+//! Move to the next item in key order.
+//!
+//! \return True if cursor still points to an item.
+//!
+bool TreeCursor::next()
+{
+    if(leafNode == nullptr)
+        return false;
+    if(++slot < getLeaf()->getNumOfItems())
+        return true;
+    return stepLeaf(true);
+}
+
+
+//! Move to the previous item in key order.
+//!
+//! \return True if cursor still points to an item.
+//!
+bool TreeCursor::prev()
+{
+    if(leafNode == nullptr)
+        return false;
+    if(slot > 0) {
+        --slot;
+        return true;
+    }
+    return stepLeaf(false);
+}
+
+
+//! Return current item, which keeps its leaf pinned.
+ItemPtr TreeCursor::getItem() const
+{
+    if(leafNode == nullptr)
+        return ItemPtr();
+    return ItemPtr(leafNode, getLeaf()->getItem(slot));
+}
+
+
+//! Descend to the first or last leaf under a node.
+//!
+//! \param node Node to start from.
+//! \param forward True to take the leftmost path, false for the rightmost one.
+//!
+//! \return False if an empty or unreadable node is met, path then ends above it.
+//!
+bool TreeCursor::descendEdge(NodePtr node, bool forward)
+{
+    while(!node->nodeHeader->isLeafNode()) {
+        const InternalNode *internal = static_cast<const InternalNode*>(node.get());
+        const auto &vecPtr = internal->keyPointers;
+        if(vecPtr.empty())
+            return false;
+
+        size_t index = forward ? 0 : vecPtr.size() - 1;
+        path.push_back(Level{node, index});
+        if(forward)
+            btrPool->prefetchChildren(internal, index, BtrfsPool::PREFETCH_WINDOW);
+        node = btrPool->getNode(vecPtr[index]->getBlkNum());
+        if(node == nullptr)
+            return false;
+        checkDescent(path.size(), internal, node.get());
+    }
+
+    const LeafNode *leaf = static_cast<const LeafNode*>(node.get());
+    if(leaf->getNumOfItems() == 0)
+        return false;
+
+    leafNode = node;
+    slot = forward ? 0 : leaf->getNumOfItems() - 1;
+    return true;
+}
+
+
+//! Move to the first item of the next leaf, or the last item of the previous leaf.
+//!
+//! \param forward True to move to the next leaf.
+//!
+//! \return True if such a leaf exists.
+//!
+bool TreeCursor::stepLeaf(bool forward)
+{
+    leafNode.reset();
+
+    while(!path.empty()) {
+        Level &level = path.back();
+        const InternalNode *internal = static_cast<const InternalNode*>(level.node.get());
+        const auto &vecPtr = internal->keyPointers;
+
+        bool hasSibling = forward ? level.index + 1 < vecPtr.size() : level.index > 0;
+        if(!hasSibling) {
+            path.pop_back();
+            continue;
+        }
+
+        level.index = forward ? level.index + 1 : level.index - 1;
+        //The read ahead window moves by one child.
+        if(forward)
+            btrPool->prefetchChildren(internal, level.index + BtrfsPool::PREFETCH_WINDOW - 1, 1);
+        NodePtr child = btrPool->getNode(vecPtr[level.index]->getBlkNum());
+        if(child != nullptr)
+            checkDescent(path.size(), internal, child.get());
+        //On failure, the deepest level reached is stepped further.
+        if(child != nullptr && descendEdge(child, forward))
+            return true;
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,63 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class TreeCursor.
+
+#ifndef TREE_CURSOR_H
+#define TREE_CURSOR_H
+
+#include <vector>
+#include "Trees/Trees.h"
+
+namespace btrForensics {
+    class BtrfsPool;
+
+    //! Position in a btrfs tree, moving over items in key order.
+    //!
+    //! The path from root to current leaf is kept, so moving to
+    //! a neighbouring leaf does not restart from the root.
+    class TreeCursor {
+    private:
+        //! Position in an internal node on the path to current leaf.
+        struct Level {
+            NodePtr node; //!< The internal node.
+            size_t index; //!< Index of the key pointer being followed.
+        };
+
+        const BtrfsPool *btrPool;
+        NodePtr root; //!< Root node of the tree.
+        std::vector<Level> path; //!< Internal nodes above current leaf.
+        NodePtr leafNode; //!< Current leaf, empty if cursor is not valid.
+        uint32_t slot; //!< Index of current item in the leaf.
+
+    public:
+        TreeCursor(const BtrfsPool *pool, const BtrfsNode *rootNode);
+
+        bool first();
+        bool seek(const BtrfsKey &key);
+        bool next();
+        bool prev();
+
+        //! Return true if cursor points to an item.
+        bool isValid() const { return leafNode != nullptr; }
+
+        //! Return current leaf node.
+        const LeafNode* getLeaf() const { return static_cast<const LeafNode*>(leafNode.get()); }
+        //! Return index of current item in its leaf.
+        uint32_t getSlot() const { return slot; }
+        //! Return key of current item.
+        const BtrfsKey& getKey() const { return getLeaf()->getKey(slot); }
+        //! Return object id in key of current item.
+        uint64_t getObjId() const { return getLeaf()->getObjId(slot); }
+        //! Return item type in key of current item.
+        ItemType getItemType() const { return getLeaf()->getItemType(slot); }
+
+        ItemPtr getItem() const;
+
+    private:
+        bool descendEdge(NodePtr node, bool forward);
+        bool stepLeaf(bool forward);
+    };
+}
+
+#endif
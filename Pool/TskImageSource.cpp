@@ -0,0 +1,117 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class TskImageSource.
+
+#include "TskImageSource.h"
+
+namespace btrForensics {
+
+//! Constructor of TskImageSource.
+//!
+//! \param img Image opened by TSK.
+//!
+TskImageSource::TskImageSource(TSK_IMG_INFO *img)
+    :image(img), idleHandles{img}, maxHandles(1)
+{
+}
+
+
+//! Destructor, closes handles opened by this source.
+TskImageSource::~TskImageSource()
+{
+    for(auto handle : openedHandles)
+        tsk_img_close(handle);
+}
+
+
+//! Read data from the image with tsk_img_read.
+ssize_t TskImageSource::read(uint64_t offset, char *data, size_t size) const
+{
+    TSK_IMG_INFO *handle = acquireHandle();
+    ssize_t result = tsk_img_read(handle, offset, data, size);
+    releaseHandle(handle);
+    return result;
+}
+
+
+//! Take an idle handle, opening a new one if all are busy.
+//!
+//! \return The handle, or the caller's image if no more can be opened.
+//!
+TSK_IMG_INFO* TskImageSource::acquireHandle() const
+{
+    std::lock_guard<std::mutex> guard(handleLock);
+    if(!idleHandles.empty()) {
+        TSK_IMG_INFO *handle = idleHandles.back();
+        idleHandles.pop_back();
+        return handle;
+    }
+
+    if(openedHandles.size() + 1 < maxHandles
+            && image->num_img > 0 && image->images != nullptr) {
+        TSK_IMG_INFO *handle = tsk_img_open(image->num_img, image->images,
+                                    image->itype, image->sector_size);
+        if(handle != nullptr) {
+            openedHandles.push_back(handle);
+            return handle;
+        }
+    }
+    //Share the caller's image, TSK serializes reads on it.
+    return image;
+}
+
+
+//! Return a handle after a read.
+//!
+//! Handles beyond the limit, left after it is lowered, are closed.
+//!
+void TskImageSource::releaseHandle(TSK_IMG_INFO *handle) const
+{
+    std::lock_guard<std::mutex> guard(handleLock);
+    for(auto idle : idleHandles) {
+        if(idle == handle)
+            return; //Shared image already returned by another read.
+    }
+    if(handle != image && openedHandles.size() + 1 > maxHandles) {
+        for(auto it = openedHandles.begin(); it != openedHandles.end(); ++it) {
+            if(*it == handle) {
+                openedHandles.erase(it);
+                break;
+            }
+        }
+        tsk_img_close(handle);
+        return;
+    }
+    idleHandles.push_back(handle);
+}
+
+
+//! Set the number of threads which may read at the same time.
+//!
+//! Each handle has its own TSK cache, so no more handles are kept
+//! than there are readers. Idle handles beyond the limit are closed.
+//!
+//! \param readers Number of reading threads.
+//!
+void TskImageSource::setMaxReaders(unsigned readers)
+{
+    std::lock_guard<std::mutex> guard(handleLock);
+    maxHandles = readers == 0 ? 1 : readers;
+    for(auto it = idleHandles.begin(); it != idleHandles.end() && openedHandles.size() + 1 > maxHandles; ) {
+        if(*it == image) {
+            ++it;
+            continue;
+        }
+        for(auto opened = openedHandles.begin(); opened != openedHandles.end(); ++opened) {
+            if(*opened == *it) {
+                openedHandles.erase(opened);
+                break;
+            }
+        }
+        tsk_img_close(*it);
+        it = idleHandles.erase(it);
+    }
+}
+
+}
@@ -0,0 +1,40 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class TskImageSource.
+
+#ifndef TSK_IMAGE_SOURCE_H
+#define TSK_IMAGE_SOURCE_H
+
+#include <mutex>
+#include <vector>
+#include "ImageSource.h"
+
+namespace btrForensics {
+
+    //! Image read through The Sleuth Kit.
+    //!
+    //! TSK serializes reads on one handle, so concurrent reads are given
+    //! their own handles, opened from the same image files on demand.
+    class TskImageSource : public ImageSource {
+    private:
+        TSK_IMG_INFO *image; //!< Image file
+        mutable std::mutex handleLock; //!< Guards the handle lists.
+        mutable std::vector<TSK_IMG_INFO*> idleHandles; //!< Handles not used by any read.
+        mutable std::vector<TSK_IMG_INFO*> openedHandles; //!< Handles opened by this source.
+        size_t maxHandles; //!< Maximum number of handles including the caller's image.
+
+    public:
+        TskImageSource(TSK_IMG_INFO *img);
+        ~TskImageSource();
+
+        ssize_t read(uint64_t offset, char *data, size_t size) const override;
+        void setMaxReaders(unsigned readers) override;
+
+    private:
+        TSK_IMG_INFO* acquireHandle() const;
+        void releaseHandle(TSK_IMG_INFO *handle) const;
+    };
+}
+
+#endif
@@ -30,12 +30,14 @@ int main(int argc, char *argv[])
     bool dirFlag(true);
     bool fileFlag(true);
     bool recursive(false);
+    bool fullPath(false);
     uint64_t rootFsId(0);
+    unsigned threads(0);
     int option;
     vector<string> offsetStr;
     vector<TSK_OFF_T> devOffsets;
 
-    while((option = getopt(argc, argv, "DFro:s:")) != -1){
+    while((option = getopt(argc, argv, "DFpro:s:t:")) != -1){
         stringstream ss;
         switch(option){
             case 'o':
@@ -63,6 +65,19 @@ int main(int argc, char *argv[])
             case 'r':
                 recursive = true;
                 break;
+            case 'p':
+                fullPath = true;
+                break;
+            case 't': {
+                long value(0);
+                ss << optarg;
+                if(!(ss >> value) || !ss.eof() || value < 1) {
+                    cerr << "Invalid number of threads: " << optarg << endl;
+                    exit(1);
+                }
+                threads = value > BtrfsPool::MAX_THREADS ? BtrfsPool::MAX_THREADS : value;
+                break;
+            }
             case '?':
             default:
                 cerr << "Unkown arguments." << endl;
@@ -97,6 +112,8 @@ int main(int argc, char *argv[])
 
     try {
         BtrfsPool btr(img, TSK_LIT_ENDIAN, devOffsets, rootFsId);
+        if(threads != 0)
+            btr.setThreads(threads);
 
         uint64_t targetId(btr.fsTree->rootDirId);
         if(argc -1 > optind) {
@@ -105,7 +122,13 @@ int main(int argc, char *argv[])
             ss >> targetId;
         }
 
-        btr.fsTree->listDirItemsById(targetId, dirFlag, fileFlag, recursive, 0, cout);
+        //A full listing reads the whole tree once instead of searching per directory.
+        if(recursive && targetId == btr.fsTree->rootDirId)
+            btr.fsTree->listDirItemsBulk(targetId, dirFlag, fileFlag, cout, fullPath);
+        else if(recursive && btr.getThreads() > 1)
+            btr.fsTree->listDirItemsParallel(targetId, dirFlag, fileFlag, cout, fullPath);
+        else
+            btr.fsTree->listDirItemsById(targetId, dirFlag, fileFlag, recursive, 0, cout, fullPath);
     } catch(std::bad_alloc& ba) {
         cerr << "Error when allocating objects.\n" << ba.what() << endl;
     } catch(FsDamagedException& fsEx) {
@@ -28,11 +28,12 @@ int main(int argc, char *argv[])
 {
     TSK_OFF_T offsetSector(0);
     uint64_t rootFsId(0);
+    string path;
     int option;
     vector<string> offsetStr;
     vector<TSK_OFF_T> devOffsets;
 
-    while((option = getopt(argc, argv, "o:s:")) != -1){
+    while((option = getopt(argc, argv, "o:s:p:")) != -1){
         stringstream ss;
         switch(option){
             case 'o':
@@ -49,6 +50,9 @@ int main(int argc, char *argv[])
                 ss << optarg;
                 ss >> rootFsId;
                 break;
+            case 'p':
+                path = optarg;
+                break;
             case '?':
             default:
                 cerr << "Unkown arguments." << endl;
@@ -59,7 +63,7 @@ int main(int argc, char *argv[])
         cerr << "Please provide the image name." << endl;
         exit(1);
     }
-    if(argc < optind + 2) {
+    if(path.empty() && argc < optind + 2) {
         cerr << "Please provde the file inode number." << endl;
         exit(1);
     }
@@ -89,9 +93,17 @@ int main(int argc, char *argv[])
         BtrfsPool btr(img, TSK_LIT_ENDIAN, devOffsets, rootFsId);
 
         uint64_t targetId(btr.fsTree->rootDirId);
-        stringstream ss;
-        ss << argv[optind+1];
-        ss >> targetId;
+        if(!path.empty()) {
+            if(!btr.fsTree->resolvePath(path, targetId)) {
+                cout << "Error: Path not found." << endl;
+                return 0;
+            }
+        }
+        else {
+            stringstream ss;
+            ss << argv[optind+1];
+            ss >> targetId;
+        }
 
         bool success;
         success = btr.fsTree->showInodeInfo(targetId, cout);
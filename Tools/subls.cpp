@@ -27,11 +27,13 @@ using namespace btrForensics;
 int main(int argc, char *argv[])
 {
     TSK_OFF_T offsetSector(0);
+    bool uuidFlag(false);
+    uint8_t uuid[UUID::BYTES_OF_UUID];
     int option;
     vector<string> offsetStr;
     vector<TSK_OFF_T> devOffsets;
 
-    while((option = getopt(argc, argv, "o:")) != -1){
+    while((option = getopt(argc, argv, "o:u:")) != -1){
         switch(option){
             case 'o':
                 offsetStr = strSplit(optarg, ",");
@@ -43,6 +45,13 @@ int main(int argc, char *argv[])
                     devOffsets.push_back(offsetSector);
                 }
                 break;
+            case 'u':
+                if(!UUID::parse(optarg, uuid)) {
+                    cerr << "Invalid UUID." << endl;
+                    exit(1);
+                }
+                uuidFlag = true;
+                break;
             case '?':
             default:
                 cerr << "Unkown arguments." << endl;
@@ -75,9 +84,34 @@ int main(int argc, char *argv[])
     try {
         BtrfsPool btr(img, TSK_LIT_ENDIAN, devOffsets);
 
-        vector<const BtrfsItem*> foundRootRefs;
-        btr.treeTraverse(btr.rootTree, [&foundRootRefs](const LeafNode* leaf)
-                { return filterItems(leaf, ItemType::ROOT_BACKREF, foundRootRefs); });
+        if(uuidFlag) {
+            bool found(false);
+            for(auto type : {ItemType::UUID_SUBVOL, ItemType::UUID_RECEIVED_SUBVOL}) {
+                vector<uint64_t> ids;
+                if(!btr.findSubvolsByUuid(uuid, type, ids))
+                    continue;
+                found = true;
+                if(type == ItemType::UUID_SUBVOL)
+                    cout << "The following subvolumes have the UUID:" << endl;
+                else
+                    cout << "The following subvolumes are received from the UUID:" << endl;
+                for(auto id : ids) {
+                    //Name is kept in the root backref of the subvolume.
+                    ItemPtr ref;
+                    TreeCursor cursor(&btr, btr.rootTree.get());
+                    string name;
+                    if(searchForItem(cursor, id, ItemType::ROOT_BACKREF, ref))
+                        name = static_cast<const RootRef*>(ref.get())->getDirName();
+                    cout << dec << setfill(' ') << setw(7) << id << "   " << name << '\n';
+                }
+            }
+            if(!found)
+                cout << "\nNo subvolumes or snapshots with the UUID are found.\n" << endl;
+            return 0;
+        }
+
+        vector<ItemPtr> foundRootRefs;
+        btr.findSubvolumes(foundRootRefs);
 
         if(foundRootRefs.size() == 0) {
             cout << "\nNo subvolumes or snapshots are found.\n" << endl;
@@ -86,9 +120,9 @@ int main(int argc, char *argv[])
 
         cout << "The following subvolumes or snapshots are found:" << endl;
         for(auto item : foundRootRefs) {
-            const RootRef* ref = static_cast<const RootRef*>(item);
+            const RootRef* ref = static_cast<const RootRef*>(item.get());
             cout << dec << setfill(' ') << setw(7);
-            cout << ref->getId() << "   " << ref->getDirName() << '\n';
+            cout << ref->getSubvolId() << "   " << ref->getDirName() << '\n';
         }
     } catch(std::bad_alloc& ba) {
         cerr << "Error when allocating objects.\n" << ba.what() << endl;
@@ -8,25 +8,37 @@
 
 #include <iostream>
 #include <string>
+#include <memory>
 #include <tsk/libtsk.h>
 #include "Utility/Utility.h"
 #include "Basics/Basics.h"
 
 namespace btrForensics{
     //! Represent a node in B-tree structure.
-    class BtrfsNode {
+    //!
+    //! Nodes are always owned by shared pointers, so that an item can
+    //! keep the node it belongs to alive.
+    class BtrfsNode : public std::enable_shared_from_this<BtrfsNode> {
     public:
         const BtrfsHeader *nodeHeader; //!< Header of a node.
 
         BtrfsNode(const BtrfsHeader *header);
-        ~BtrfsNode() { if(nodeHeader!=nullptr) delete nodeHeader; } //! Destructor
+        virtual ~BtrfsNode() { if(nodeHeader!=nullptr) delete nodeHeader; } //! Destructor
 
         //! Return infomation about the node.
         //! Virtual function to be overridden by derived classes.
         virtual const std::string info() const = 0;
+
+        //! Return bytes of memory held by the node.
+        virtual uint64_t getFootprint() const = 0;
     };
 
+    //! Shared pointer to a node, holding it pins the node in the node cache.
+    using NodePtr = std::shared_ptr<const BtrfsNode>;
+
+    //! Shared pointer to an item, holding it pins the leaf storing the item.
+    using ItemPtr = std::shared_ptr<const BtrfsItem>;
+
 }
 
 #endif
-
@@ -10,6 +10,7 @@
 #include <string>
 #include <tsk/libtsk.h>
 #include "Basics/Basics.h"
+#include "BtrfsNode.h"
 
 namespace btrForensics {
     class BtrfsPool;
@@ -18,17 +19,16 @@ namespace btrForensics {
     //! Process chunk tree of Btrfs.
     class ChunkTree {
     public:
-        const BtrfsNode* chunkRoot; //!< Root of chunk tree.
+        NodePtr chunkRoot; //!< Root of chunk tree.
     private:
         BtrfsPool* btrPool;
 
     public:
         ChunkTree(BtrfsPool *pool);
         ~ChunkTree();
-        
-        bool findChunkItem(const LeafNode* leaf, uint64_t targetLogAddr,
-                const ChunkItem* &foundChunk) const;
-        const ChunkItem* getChunkItem(uint64_t logicalAddr) const;
+
+    private:
+        void mapChunkItems(const LeafNode* leaf);
     };
 
 }
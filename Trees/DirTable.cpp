@@ -0,0 +1,71 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class DirTable.
+
+#include <algorithm>
+#include "DirTable.h"
+#include "LeafNode.h"
+
+namespace btrForensics {
+
+//! Add dir index items and inode items of a leaf.
+//!
+//! \param leaf Leaf following all leaves added before in key order.
+//!
+void DirTable::addLeaf(const LeafNode *leaf)
+{
+    for(uint32_t i=0; i<leaf->getNumOfItems(); ++i) {
+        ItemType type = leaf->getItemType(i);
+        if(type == ItemType::INODE_ITEM) {
+            inodes.push_back(leaf->getObjId(i));
+        }
+        else if(type == ItemType::DIR_INDEX) {
+            const DirItem *dir = static_cast<const DirItem*>(leaf->getItem(i));
+            std::string name = dir->getDirName();
+            entries.push_back(Entry{leaf->getObjId(i), dir->getTargetInode(),
+                names.size(), (uint16_t)name.size(), dir->getTargetType(), dir->type});
+            names += name;
+        }
+    }
+}
+
+
+//! Append another table, whose leaves follow this one in key order.
+void DirTable::append(const DirTable &other)
+{
+    uint64_t nameBase = names.size();
+    entries.reserve(entries.size() + other.entries.size());
+    for(auto entry : other.entries) {
+        entry.nameOffset += nameBase;
+        entries.push_back(entry);
+    }
+    names += other.names;
+    inodes.insert(inodes.end(), other.inodes.begin(), other.inodes.end());
+}
+
+
+//! Check if an inode item exists for an inode number.
+bool DirTable::hasInode(uint64_t inodeNum) const
+{
+    return std::binary_search(inodes.begin(), inodes.end(), inodeNum);
+}
+
+
+//! Get entries of a directory.
+//!
+//! \param dirId Inode number of the directory.
+//! \param[out] begin First entry of the directory.
+//! \param[out] end Entry after the last one of the directory.
+//!
+void DirTable::getChildren(uint64_t dirId, const Entry *&begin, const Entry *&end) const
+{
+    auto first = std::lower_bound(entries.begin(), entries.end(), dirId,
+        [](const Entry &entry, uint64_t id) { return entry.parent < id; });
+    auto last = std::upper_bound(first, entries.end(), dirId,
+        [](uint64_t id, const Entry &entry) { return id < entry.parent; });
+    begin = entries.data() + (first - entries.begin());
+    end = entries.data() + (last - entries.begin());
+}
+
+}
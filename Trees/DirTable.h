@@ -0,0 +1,56 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class DirTable.
+
+#ifndef DIR_TABLE_H
+#define DIR_TABLE_H
+
+#include <vector>
+#include <string>
+#include <tsk/libtsk.h>
+#include "Basics/Basics.h"
+
+namespace btrForensics {
+    class LeafNode;
+
+    //! Directory entries of a whole filesystem tree, indexed by parent directory.
+    //!
+    //! Filled by a sweep over leaves in key order, so entries of a directory
+    //! are adjacent and in the order of their dir index items.
+    class DirTable {
+    public:
+        //! Entry of a directory.
+        struct Entry {
+            uint64_t parent; //!< Inode number of the directory.
+            uint64_t target; //!< Object id the entry points to.
+            uint64_t nameOffset; //!< Offset of the name in the name pool.
+            uint16_t nameSize; //!< Size of the name.
+            ItemType targetType; //!< Item type the entry points to.
+            DirItemType type; //!< Type of the entry.
+        };
+
+    private:
+        std::vector<Entry> entries; //!< All entries, in key order.
+        std::string names; //!< Names of all entries, back to back.
+        std::vector<uint64_t> inodes; //!< Inode numbers having an inode item, sorted.
+
+    public:
+        void addLeaf(const LeafNode *leaf);
+        void append(const DirTable &other);
+
+        bool hasInode(uint64_t inodeNum) const;
+        void getChildren(uint64_t dirId, const Entry *&begin, const Entry *&end) const;
+
+        //! Return name of an entry.
+        std::string getName(const Entry &entry) const
+        {
+            return names.substr(entry.nameOffset, entry.nameSize);
+        }
+
+        //! Return number of entries.
+        size_t size() const { return entries.size(); }
+    };
+}
+
+#endif
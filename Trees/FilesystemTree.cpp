@@ -9,8 +9,21 @@
 #include <iomanip>
 #include <functional>
 #include <vector>
+#include <memory>
+#include <deque>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
 #include "FilesystemTree.h"
 #include "Pool/Functions.h"
+#include "Utility/Decompress.h"
+#include "Utility/Crc32c.h"
+#include "Utility/StringProcess.h"
 
 using namespace std;
 
@@ -24,14 +37,13 @@ namespace btrForensics {
 //!
 FilesystemTree::FilesystemTree(const BtrfsNode* rootNode,
         uint64_t rootItemId, BtrfsPool* pool)
-        :btrPool(pool)
+        :fsId(rootItemId), btrPool(pool)
 {
-    const BtrfsItem* foundItem;
+    ItemPtr foundItem;
     const RootItem* rootItm;
-    if(btrPool->treeSearchById(rootNode, rootItemId,
-            [&foundItem](const LeafNode* leaf, uint64_t targetId)
-            { return searchForItem(leaf, targetId, ItemType::ROOT_ITEM, foundItem); })) {
-        rootItm = static_cast<const RootItem*>(foundItem);
+    TreeCursor cursor(btrPool, rootNode);
+    if(searchForItem(cursor, rootItemId, ItemType::ROOT_ITEM, foundItem)) {
+        rootItm = static_cast<const RootItem*>(foundItem.get());
     }
     else {
         ostringstream oss;
@@ -40,34 +52,15 @@ FilesystemTree::FilesystemTree(const BtrfsNode* rootNode,
     }
 
     uint64_t offset = rootItm->getBlockNumber();
-    const SuperBlock *supBlk = btrPool->primarySupblk;
-
-    char *headerArr = new char[BtrfsHeader::SIZE_OF_HEADER]();
-    uint64_t physicalAddr = btrPool->readData(headerArr, offset, BtrfsHeader::SIZE_OF_HEADER);
     rootDirId = rootItm->getRootObjId();
 
-    const BtrfsHeader *fileTreeHeader = 
-        new BtrfsHeader(TSK_LIT_ENDIAN, (uint8_t*)headerArr);
-    delete [] headerArr;
-
-    uint64_t itemOffset = physicalAddr + BtrfsHeader::SIZE_OF_HEADER;
-
-    if(fileTreeHeader->isLeafNode()){
-        fileTreeRoot = new LeafNode(btrPool->image, 
-                            fileTreeHeader, btrPool->endian, itemOffset);
-    }
-    else {
-        fileTreeRoot = new InternalNode(btrPool->image, 
-                            fileTreeHeader, btrPool->endian, itemOffset);
-    }
+    fileTreeRoot = btrPool->getNode(offset);
 }
 
 
 //!< Destructor
 FilesystemTree::~FilesystemTree()
 {
-    if(fileTreeRoot != nullptr)
-        delete fileTreeRoot;
 }
 
 
@@ -81,8 +74,10 @@ void FilesystemTree::listDirItems(ostream &os)
 
     //Choose Lamba over std::bind.
     //See "Effective Modern C++" Item 34.
-    btrPool->treeTraverse(fileTreeRoot,
-            [&os](const LeafNode *leaf) { printLeafDir(leaf, os); });
+    //Leaves are printed into one buffer per subtree, written out in key order.
+    btrPool->parallelTraverse<ostringstream>(fileTreeRoot.get(),
+            [](const LeafNode *leaf, ostringstream &oss) { printLeafDir(leaf, oss); },
+            [&os](ostringstream &oss) { os << oss.str(); });
 }
 
 
@@ -94,103 +89,485 @@ void FilesystemTree::listDirItems(ostream &os)
 //! \param recursive Whether list items recursively in subdirectories.
 //! \param level Level used to determine number of "+"s, usually set as 0.
 //! \param os Output stream where the infomation is printed.
+//! \param fullPath Whether to print full paths instead of names.
 //!
 void FilesystemTree::listDirItemsById(uint64_t id, bool dirFlag, bool fileFlag,
-    bool recursive, int level, std::ostream& os)
+    bool recursive, int level, std::ostream& os, bool fullPath)
 {
-    DirContent* dir = getDirContent(id);
-    if(dir == nullptr) {
+    DirReader reader(btrPool, fileTreeRoot.get());
+    if(!reader.open(id))
         return;
+
+    PathResolver::PrefixPtr prefix;
+    string prefixText;
+    if(fullPath) {
+        prefix = btrPool->pathResolver.getDirPath(this, id);
+        prefixText = PathResolver::toString(prefix);
+    }
+
+    vector<DirReader::EntryPtr> batch;
+    while(reader.read(batch)) {
+        for(auto &child : batch) {
+            if(child->getTargetType() != ItemType::INODE_ITEM)
+                continue;
+            if((fileFlag && child->type == DirItemType::REGULAR_FILE) 
+                    || (dirFlag && child->type == DirItemType::DIRECTORY))
+                printDirEntry(os, level, child->type, child->getTargetInode(),
+                        fullPath ? &prefixText : nullptr, child->getDirName());
+            if(recursive && child->type == DirItemType::DIRECTORY) {
+                uint64_t newId = child->targetKey.objId;
+                if(fullPath)
+                    btrPool->pathResolver.addDir(this, newId, prefix, child->getDirName());
+                listDirItemsById(newId, dirFlag, fileFlag, recursive, level+1, os, fullPath);
+            }
+        }
     }
+}
+
 
-    for(auto child : dir->children) {
-        if(child->getTargetType() != ItemType::INODE_ITEM)
+//! List all directory items under a directory recursively, reading the tree once.
+//!
+//! Leaves are swept in key order to build a table of all directory entries,
+//! the hierarchy is then printed from memory in the same order as
+//! listDirItemsById does.
+//!
+//! \param id Id of the target directory.
+//! \param dirFlag Whether to list directories.
+//! \param fileFlag Whether to list regular files.
+//! \param os Output stream where the infomation is printed.
+//! \param fullPath Whether to print full paths instead of names.
+//!
+void FilesystemTree::listDirItemsBulk(uint64_t id, bool dirFlag, bool fileFlag,
+    std::ostream& os, bool fullPath)
+{
+    DirTable table;
+    btrPool->parallelTraverse<DirTable>(fileTreeRoot.get(),
+            [](const LeafNode *leaf, DirTable &part) { part.addLeaf(leaf); },
+            [&table](DirTable &part) { table.append(part); });
+
+    if(!table.hasInode(id))
+        return;
+
+    //Entries left to print in each directory on the current path.
+    struct Frame {
+        uint64_t dirId;
+        const DirTable::Entry *next;
+        const DirTable::Entry *end;
+        PathResolver::PrefixPtr prefix; //Path of the directory, empty if not printed.
+        string prefixText; //Text of the path, built once for all entries.
+    };
+    vector<Frame> stack(1);
+    stack[0].dirId = id;
+    table.getChildren(id, stack[0].next, stack[0].end);
+    if(fullPath) {
+        stack[0].prefix = btrPool->pathResolver.getDirPath(this, id);
+        stack[0].prefixText = PathResolver::toString(stack[0].prefix);
+    }
+
+    while(!stack.empty()) {
+        Frame &frame = stack.back();
+        if(frame.next == frame.end) {
+            stack.pop_back();
             continue;
-        if((fileFlag && child->type == DirItemType::REGULAR_FILE) 
-                || (dirFlag && child->type == DirItemType::DIRECTORY)) {
-            if(level!=0) os << string(level, '+') << " ";
-            os << child->type << '/' << child->type << " ";
-            ostringstream oss;
-            oss << dec << child->getTargetInode() << ':';
-            os << setfill(' ') << setw(9) << left << oss.str();
-            os << " " << child->getDirName() << endl;
         }
-        if(recursive && child->type == DirItemType::DIRECTORY) {
-            uint64_t newId = child->targetKey.objId;
-            listDirItemsById(newId, dirFlag, fileFlag, recursive, level+1, os);
+
+        const DirTable::Entry &child = *frame.next++;
+        int level = stack.size() - 1;
+        if(child.targetType != ItemType::INODE_ITEM)
+            continue;
+        if((fileFlag && child.type == DirItemType::REGULAR_FILE) 
+                || (dirFlag && child.type == DirItemType::DIRECTORY))
+            printDirEntry(os, level, child.type, child.target,
+                    fullPath ? &frame.prefixText : nullptr, table.getName(child));
+
+        if(child.type != DirItemType::DIRECTORY || !table.hasInode(child.target))
+            continue;
+        //A damaged tree may contain a directory inside itself.
+        bool loop(false);
+        for(auto &ancestor : stack)
+            loop = loop || ancestor.dirId == child.target;
+        if(loop)
+            continue;
+
+        Frame subdir;
+        subdir.dirId = child.target;
+        table.getChildren(child.target, subdir.next, subdir.end);
+        if(fullPath) {
+            subdir.prefix = btrPool->pathResolver.addDir(this, child.target, frame.prefix, table.getName(child));
+            subdir.prefixText = PathResolver::toString(subdir.prefix);
         }
+        stack.push_back(move(subdir));
     }
 }
 
 
-//! Locate the directory with give inode number.
+//! List all directory items under a directory recursively, using multiple threads.
+//!
+//! Subdirectories are read by worker threads. Each worker hands over the
+//! output of a directory after every batch of entries, and the calling thread
+//! prints it as soon as the listings before it are printed. The output is the
+//! same as listDirItemsById with recursive set.
+//!
+//! Once MAX_LISTING_BUFFER bytes are held ahead of printing, workers only go on
+//! with the directory being printed, or with any directory when that one waits
+//! for a worker and all workers are busy.
 //!
-//! \param id Inode number of directory.
+//! \param id Id of the target directory.
+//! \param dirFlag Whether to list directories.
+//! \param fileFlag Whether to list regular files.
+//! \param os Output stream where the infomation is printed.
+//! \param fullPath Whether to print full paths instead of names.
 //!
-DirContent* FilesystemTree::getDirContent(uint64_t id)
+void FilesystemTree::listDirItemsParallel(uint64_t id, bool dirFlag, bool fileFlag,
+    std::ostream& os, bool fullPath)
 {
-    const BtrfsItem* foundItem;
-    if(btrPool->treeSearchById(fileTreeRoot, id,
-            [&foundItem](const LeafNode* leaf, uint64_t targetId)
-            { return searchForItem(leaf, targetId, ItemType::INODE_ITEM, foundItem); })) {
-        const InodeItem* rootInode = static_cast<const InodeItem*>(foundItem);
-
-        btrPool->treeSearchById(fileTreeRoot, id,
-            [&foundItem](const LeafNode* leaf, uint64_t targetId)
-            { return searchForItem(leaf, targetId, ItemType::INODE_REF, foundItem); });
-        const InodeRef* rootRef = static_cast<const InodeRef*>(foundItem);
-
-        vector<const BtrfsItem*> foundItems;
-        btrPool->treeSearchById(fileTreeRoot, id,
-            [&foundItems](const LeafNode* leaf, uint64_t targetId)
-            { return filterItems(leaf, targetId, ItemType::DIR_INDEX, foundItems); });
-        
-        return new DirContent(rootInode, rootRef, foundItems);
+    //Output of a directory up to one of its subdirectories.
+    struct Chunk {
+        string text;
+        size_t subdir; //Index of the subdirectory listing, 0 if none.
+    };
+
+    //Output of one directory, handed over while it is read.
+    struct Listing {
+        uint64_t dirId;
+        int level;
+        size_t parent;
+        bool taken;
+        bool done;
+        deque<Chunk> chunks; //Output not printed yet.
+        PathResolver::PrefixPtr prefix; //Path of the directory, empty if not printed.
+    };
+
+    map<size_t, Listing> listings; //Removed once printed, references stay valid.
+    size_t nextIndex(1);
+    vector<size_t> pending; //Listings to be taken, next one at the back.
+    size_t cursor(0); //Listing being printed.
+    uint64_t buffered(sizeof(Listing)); //Bytes held by listings and their output.
+    unsigned threads(btrPool->getThreads());
+    unsigned working(0);
+    bool stop(false);
+    exception_ptr failure;
+    mutex lock;
+    condition_variable changed;
+
+    listings[0] = Listing{id, 0, 0, false, false};
+    if(fullPath)
+        listings[0].prefix = btrPool->pathResolver.getDirPath(this, id);
+    pending.push_back(0);
+
+    //Check whether the listing being printed waits for a worker.
+    auto cursorWaiting = [&]() {
+        auto current = listings.find(cursor);
+        return current != listings.end() && !current->second.taken;
+    };
+
+    //Drop entries of listings taken out of order, check whether any is left.
+    auto havePending = [&]() {
+        while(!pending.empty()) {
+            auto found = listings.find(pending.back());
+            if(found != listings.end() && !found->second.taken)
+                return true;
+            pending.pop_back();
+        }
+        return false;
+    };
+
+    //Hand over output of a batch, called with the lock held.
+    auto handOver = [&](size_t index, vector<string> &texts, vector<uint64_t> &subdirIds,
+            vector<PathResolver::PrefixPtr> &subdirPrefixes) {
+        Listing &listing = listings[index];
+        size_t first = listing.chunks.size();
+        for(size_t i = 0; i < texts.size(); ++i) {
+            buffered += texts[i].size() + sizeof(Chunk);
+            listing.chunks.push_back(Chunk{move(texts[i]), 0});
+            if(i >= subdirIds.size())
+                break;
+
+            uint64_t subdirId = subdirIds[i];
+            //A damaged tree may contain a directory inside itself.
+            bool loop(listing.dirId == subdirId);
+            for(size_t j = index; j != 0 && !loop; ) {
+                j = listings[j].parent;
+                loop = listings[j].dirId == subdirId;
+            }
+            buffered += sizeof(Listing);
+            Listing &subdir = listings[nextIndex];
+            subdir = Listing{subdirId, listing.level + 1, index, loop, loop};
+            if(fullPath)
+                subdir.prefix = subdirPrefixes[i];
+            listing.chunks.back().subdir = nextIndex++;
+        }
+        //Taken in output order, so the printing rarely waits.
+        for(size_t i = listing.chunks.size(); i > first; --i) {
+            size_t subdir = listing.chunks[i - 1].subdir;
+            if(subdir != 0 && !listings[subdir].taken)
+                pending.push_back(subdir);
+        }
+        texts.clear();
+        subdirIds.clear();
+        subdirPrefixes.clear();
+        changed.notify_all();
+    };
+
+    auto work = [&]() {
+        unique_lock<mutex> guard(lock);
+        while(true) {
+            changed.wait(guard, [&]() {
+                if(stop || cursorWaiting())
+                    return true;
+                if(havePending())
+                    return buffered < MAX_LISTING_BUFFER;
+                return working == 0;
+            });
+            if(stop || !havePending())
+                return;
+            //The listing being printed goes first.
+            size_t index = cursorWaiting() ? cursor : pending.back();
+            Listing &listing = listings[index];
+            listing.taken = true;
+            uint64_t dirId = listing.dirId;
+            int level = listing.level;
+            PathResolver::PrefixPtr prefix = listing.prefix;
+            ++working;
+            guard.unlock();
+
+            try {
+                string prefixText;
+                if(fullPath)
+                    prefixText = PathResolver::toString(prefix);
+                DirReader reader(btrPool, fileTreeRoot.get());
+                vector<DirReader::EntryPtr> batch;
+                vector<string> texts;
+                vector<uint64_t> subdirIds;
+                vector<PathResolver::PrefixPtr> subdirPrefixes;
+                ostringstream oss;
+                if(reader.open(dirId)) {
+                    while(reader.read(batch)) {
+                        for(auto &child : batch) {
+                            if(child->getTargetType() != ItemType::INODE_ITEM)
+                                continue;
+                            if((fileFlag && child->type == DirItemType::REGULAR_FILE)
+                                    || (dirFlag && child->type == DirItemType::DIRECTORY))
+                                printDirEntry(oss, level, child->type, child->getTargetInode(),
+                                        fullPath ? &prefixText : nullptr, child->getDirName());
+                            if(child->type == DirItemType::DIRECTORY) {
+                                texts.push_back(oss.str());
+                                oss.str("");
+                                subdirIds.push_back(child->targetKey.objId);
+                                if(fullPath)
+                                    subdirPrefixes.push_back(btrPool->pathResolver.addDir(this,
+                                                child->targetKey.objId, prefix, child->getDirName()));
+                            }
+                        }
+                        if(oss.tellp() > 0) {
+                            texts.push_back(oss.str());
+                            oss.str("");
+                        }
+                        if(texts.empty())
+                            continue;
+                        guard.lock();
+                        handOver(index, texts, subdirIds, subdirPrefixes);
+                        changed.wait(guard, [&]() {
+                            return stop || buffered < MAX_LISTING_BUFFER || index == cursor
+                                || (working == threads && cursorWaiting());
+                        });
+                        bool stopped(stop);
+                        guard.unlock();
+                        if(stopped)
+                            break;
+                    }
+                }
+            } catch(...) {
+                guard.lock();
+                if(!failure)
+                    failure = current_exception();
+                stop = true;
+                --working;
+                changed.notify_all();
+                return;
+            }
+
+            guard.lock();
+            listing.done = true;
+            --working;
+            changed.notify_all();
+        }
+    };
+
+    vector<thread> workers;
+    for(unsigned i = 0; i < threads; ++i)
+        workers.emplace_back(work);
+
+    //Listings on the current output path.
+    vector<size_t> path(1, 0);
+    unique_lock<mutex> guard(lock);
+    while(!path.empty()) {
+        Listing &listing = listings[path.back()];
+        changed.wait(guard, [&]() { return stop || !listing.chunks.empty() || listing.done; });
+        if(stop)
+            break;
+
+        if(listing.chunks.empty()) {
+            listings.erase(path.back());
+            buffered -= sizeof(Listing);
+            path.pop_back();
+            cursor = path.empty() ? 0 : path.back();
+            changed.notify_all();
+            continue;
+        }
+
+        Chunk chunk(move(listing.chunks.front()));
+        listing.chunks.pop_front();
+        bool full(buffered >= MAX_LISTING_BUFFER);
+        buffered -= chunk.text.size() + sizeof(Chunk);
+        if(chunk.subdir != 0) {
+            path.push_back(chunk.subdir);
+            cursor = chunk.subdir;
+            changed.notify_all();
+        }
+        else if(full && buffered < MAX_LISTING_BUFFER)
+            changed.notify_all();
+
+        guard.unlock();
+        os << chunk.text;
+        guard.lock();
     }
-    return nullptr;
+    stop = true;
+    changed.notify_all();
+    guard.unlock();
+
+    for(auto &worker : workers)
+        worker.join();
+    if(failure)
+        rethrow_exception(failure);
+}
+
+
+//! Print one directory entry in the format of fls.
+//!
+//! \param os Output stream where the infomation is printed.
+//! \param level Level used to determine number of "+"s.
+//! \param type Type of the entry.
+//! \param inodeNum Inode number the entry points to.
+//! \param prefix Path of the parent directory printed before the name instead of "+"s, may be null.
+//! \param name Name of the entry.
+//!
+void FilesystemTree::printDirEntry(std::ostream& os, int level, DirItemType type,
+    uint64_t inodeNum, const std::string *prefix, const std::string &name)
+{
+    if(level!=0 && prefix == nullptr) os << string(level, '+') << " ";
+    os << type << '/' << type << " ";
+    ostringstream oss;
+    oss << dec << inodeNum << ':';
+    os << setfill(' ') << setw(9) << left << oss.str();
+    os << " ";
+    if(prefix != nullptr) os << *prefix;
+    os << name << '\n';
+}
+
+
+//! Print entries of a directory as they are read.
+//!
+//! \param reader Reader opened at the directory, all entries are consumed.
+//! \param os Output stream where the infomation is printed.
+//! \param subvolumes Stream receiving entries of subvolumes, may be null.
+//!
+static void printDirContent(DirReader &reader, ostream &os, ostream *subvolumes)
+{
+    vector<DirReader::EntryPtr> batch;
+    os << "[" << reader.getName() << "]" << endl;
+    while(reader.read(batch)) {
+        for(auto &child : batch) {
+            if(child->getTargetType() == ItemType::ROOT_ITEM) {
+                if(subvolumes != nullptr) {
+                    ostringstream oss;
+                    *subvolumes << "  \e(0\x74\x71\e(B" << dec;
+                    oss << "[" << child->getTargetInode() << "]";
+                    *subvolumes << setfill(' ') << setw(9) << oss.str();
+                    *subvolumes << "  " << child->getDirName() << '\n';
+                }
+                continue;
+            }
+
+            os << "  |" << dec;
+            os << setfill('-') << setw(8) << child->getTargetInode();
+
+            if(child->type == DirItemType::DIRECTORY)
+                os << "  [" << child->getDirName() << "]\n";
+            else
+                os << "  " << child->getDirName() << "\n";
+        }
+    }
+    os << endl;
+}
+
+
+//! Go through child directories of a directory in the order of a menu.
+//!
+//! The directory is read again on each call, so that child directories
+//! are not held in memory.
+//!
+//! \param reader Reader of the directory.
+//! \param os Output stream where the menu is printed, null to print nothing.
+//! \param wanted Index of the child directory to be found, starting from 1.
+//! \param found Receives inode number of the wanted child directory.
+//!
+//! \return Number of child directories.
+//!
+static int listChildDirs(DirReader &reader, ostream *os, int wanted, uint64_t &found)
+{
+    vector<DirReader::EntryPtr> batch;
+    int count(0);
+    reader.open(reader.getDirId());
+    while(reader.read(batch)) {
+        for(auto &child : batch) {
+            if(child->type != DirItemType::DIRECTORY 
+                    || child->getTargetType() != ItemType::INODE_ITEM)
+                continue;
+            if(++count == wanted)
+                found = child->getTargetInode();
+            if(os == nullptr)
+                continue;
+            if(count == 1)
+                *os << "Child directory with following inode numbers are found." << endl;
+            *os << "[" << dec << setfill(' ') << setw(2) << count << "] "
+                << setw(7) << child->getTargetInode() << "   " << child->getDirName() << '\n';
+        }
+    }
+    return count;
 }
 
 
 //! List files in a directory and navigate to subdirectory.
 //!
+//! Directories are read in batches while being printed, so a directory
+//! of any size is shown with constant memory.
+//!
 //! \param os Output stream where the infomation is printed.
 //! \param is Input stream telling which directory is the one to be read.
 //!
 const void FilesystemTree::explorFiles(std::ostream& os, istream& is)
 {
-    DirContent* dir = getDirContent(rootDirId);
-    if(dir == nullptr) {
+    DirReader reader(btrPool, fileTreeRoot.get());
+    if(!reader.open(rootDirId)) {
         os << "Root directory not found." << endl;
         return;
     }
 
     os << "Root directory content:\n" <<endl;
-    os << *dir;
+    ostringstream subvolumes;
+    printDirContent(reader, os, &subvolumes);
 
     os << "The following items are subvolumes or snapshots:" << endl;
-    for(auto dirItem : dir->children) {
-        if(dirItem->getTargetType() == ItemType::ROOT_ITEM) {
-            ostringstream oss;
-            os << "  \e(0\x74\x71\e(B" << dec;
-            oss << "[" << dirItem->getTargetInode() << "]";
-            os << setfill(' ') << setw(9) << oss.str();
-            os << "  " << dirItem->getDirName() << '\n';
-        }
-    }
+    os << subvolumes.str();
     os << endl;
 
     while(true) {
         uint64_t targetInode;
-        map<int, int> dirList;
         string input;
-        int inputId;
+        int inputId(0);
 
-        int count(0);
-        for(int i = 0; i < dir->children.size(); ++i) {
-            if(dir->children[i]->type == DirItemType::DIRECTORY 
-                    && dir->children[i]->getTargetType() == ItemType::INODE_ITEM)
-                dirList[++count] = i;
-        }
+        int count = listChildDirs(reader, &os, 0, targetInode);
         if(count == 0) {
             while(true) {
                 os << "No child directory is found.\n";
@@ -199,16 +576,10 @@ const void FilesystemTree::explorFiles(std::ostream& os, istream& is)
                 if(input == "q") return;
                 if(input == "r") break;
             }
-            targetInode = dir->ref->itemHead->key.offset;
+            targetInode = reader.getParentId();
         }
         else{
             while(true) {
-                os << "Child directory with following inode numbers are found." << endl;
-                for(auto entry : dirList) {
-                    DirItem* item = dir->children[entry.second];
-                    os << "[" << dec << setfill(' ') << setw(2) << entry.first << "] "
-                        << setw(7) << item->getTargetInode() << "   " << item->getDirName() << '\n';
-                }
                 os << endl;
                 os << "To visit a child directory, please enter its index in the list:\n";
                 os << "(Enter 'r' to return to previous directory or 'q' to quit.)" << endl;
@@ -216,106 +587,241 @@ const void FilesystemTree::explorFiles(std::ostream& os, istream& is)
                 
                 if(input == "q") return;
                 if(input == "r") {
-                    targetInode = dir->ref->itemHead->key.offset;
+                    targetInode = reader.getParentId();
                     break;
                 }
                 stringstream(input) >> inputId;
-                if(dirList.find(inputId) != dirList.end()) {
-                    int target = dirList[inputId];
-                    DirItem* targetItem = dir->children[target];
-                    targetInode = targetItem->getTargetInode();
+                if(inputId >= 1 && inputId <= count) {
+                    listChildDirs(reader, nullptr, inputId, targetInode);
                     break;
                 }
                 os << "Wrong index, please enter a correct one.\n" << endl;
+                listChildDirs(reader, &os, 0, targetInode);
             } 
             os << endl;
         }
 
-        DirContent* newDir = getDirContent(targetInode);
-        delete dir;
-        dir = newDir;
-
-        if(newDir == nullptr) {
+        if(!reader.open(targetInode)) {
             os << "Error, Directory not found." << endl;
             return;
         }
         os << std::string(60, '=') << "\n\n";
         os << "Directory content:\n" <<endl;
-        os << *dir;
+        printDirContent(reader, os, nullptr);
     }
 }
 
 
+//! Write a whole buffer to a file at given offset.
+//!
+//! \return True if all data is written.
+//!
+static bool writeAll(int fd, const char *data, uint64_t size, uint64_t offset)
+{
+    while(size > 0) {
+        ssize_t written = pwrite(fd, data, size, offset);
+        if(written < 0 && errno == EINTR)
+            continue;
+        if(written <= 0)
+            return false;
+        data += written;
+        size -= written;
+        offset += written;
+    }
+    return true;
+}
+
+
+//! Decompress an extent and write the wanted part of it to a file.
+//!
+//! \param fd File descriptor of the output file.
+//! \param compression Compression type of the extent.
+//! \param compressed Compressed data of the extent.
+//! \param decodedSize Size of the extent after decompression.
+//! \param skip Bytes of decompressed data before the wanted part.
+//! \param length Size of the wanted part.
+//! \param fileOffset Offset of the wanted part in the file.
+//! \param sectorSize Sector size of the filesystem.
+//!
+//! \return True if all data is written.
+//!
+static bool decodeExtent(int fd, uint8_t compression, vector<char> compressed,
+        uint64_t decodedSize, uint64_t skip, uint64_t length,
+        uint64_t fileOffset, uint32_t sectorSize)
+{
+    vector<char> decodedArr(decodedSize);
+    size_t decoded(0);
+    if(!decompressExtent(compression, compressed.data(), compressed.size(),
+                decodedArr.data(), decodedArr.size(), sectorSize, decoded))
+        throw FsDamagedException("Compressed extent data is corrupted.");
+
+    //Bytes beyond decoded data are zeros.
+    if(skip >= decoded)
+        return true;
+    return writeAll(fd, decodedArr.data() + skip, min(length, decoded - skip), fileOffset);
+}
+
+
 //! Read file content with given inode and save to current directory.
 //!
+//! Holes and preallocated ranges are not written, leaving the output sparse.
+//! Extent items are walked with a cursor, so only the leaf of the current
+//! extent is held however fragmented the file is.
+//!
 //! \param id Inode number of the file to read.
 //!
 //! \return True if file is all successfully written.
 //!
 const bool FilesystemTree::readFile(uint64_t id)
 {
-    const BtrfsItem* foundItem;
-    if(!btrPool->treeSearchById(fileTreeRoot, id,
-            [&foundItem](const LeafNode* leaf, uint64_t targetId)
-            { return searchForItem(leaf, targetId, ItemType::INODE_ITEM, foundItem); }))
+    TreeCursor cursor(btrPool, fileTreeRoot.get());
+    ItemBundle bundle;
+    bundle.load(cursor, id, {ItemType::INODE_ITEM, ItemType::INODE_REF});
+
+    ItemPtr foundItem = bundle.getFirst(ItemType::INODE_ITEM);
+    if(foundItem == nullptr)
         return false;
-    const InodeItem* inode = static_cast<const InodeItem*>(foundItem);
+    const InodeItem* inode = static_cast<const InodeItem*>(foundItem.get());
     uint64_t fileSize = inode->getSize();
         
-    if(!btrPool->treeSearchById(fileTreeRoot, id,
-            [&foundItem](const LeafNode* leaf, uint64_t targetId)
-            { return searchForItem(leaf, targetId, ItemType::INODE_REF, foundItem); }))
+    foundItem = bundle.getFirst(ItemType::INODE_REF);
+    if(foundItem == nullptr)
         return false;
-    const InodeRef* inodeRef = static_cast<const InodeRef*>(foundItem);
+    const InodeRef* inodeRef = static_cast<const InodeRef*>(foundItem.get());
     string fileName = inodeRef->getDirName();
         
 
-    vector<const BtrfsItem*> foundExtents;
-    btrPool->treeSearchById(fileTreeRoot, id,
-            [&foundExtents](const LeafNode* leaf, uint64_t targetId)
-            { return filterItems(leaf, targetId, ItemType::EXTENT_DATA, foundExtents); });
-    if(foundExtents.size() < 1)
+    //Extent items of the file follow each other in key order.
+    auto firstExtent = [&]() {
+        return cursor.seek(BtrfsKey(id, ItemType::EXTENT_DATA, 0))
+            && cursor.getObjId() == id && cursor.getItemType() == ItemType::EXTENT_DATA;
+    };
+    auto nextExtent = [&]() {
+        return cursor.next() && cursor.getObjId() == id
+            && cursor.getItemType() == ItemType::EXTENT_DATA;
+    };
+
+    //All extents are checked before the output file is created.
+    if(!firstExtent())
         return false;
-        
-    uint64_t unreadSize = fileSize;
-    for(auto extent : foundExtents) {
-        const ExtentData* data = static_cast<const ExtentData*>(extent);
-        if(data->compression + data->encryption + data->otherEncoding != 0)
+    do {
+        ItemPtr extent = cursor.getItem();
+        const ExtentData* data = static_cast<const ExtentData*>(extent.get());
+        if(data->encryption + data->otherEncoding != 0)
             return false;
-
-        ofstream ofs(fileName, ofstream::app | ofstream::binary);
-        if(!ofs) return false;
-        if(data->type == 0) { //Is inline file.
-            char* dataArr = new char[fileSize];
-            tsk_img_read(btrPool->image, data->dataAddress, dataArr, fileSize);
-            ofs.write(dataArr, fileSize);
-            delete [] dataArr;
-            ofs.close();
-            return true;
+        if(!decompressSupported(data->compression)) {
+            ostringstream oss;
+            oss << "Compression type " << (int)data->compression
+                << " is not supported by this build.";
+            throw runtime_error(oss.str());
+        }
+        //Btrfs never compresses more than 128 KiB into one extent.
+        if(data->compression != COMPRESS_NONE && (data->decodedSize > MAX_COMPRESSED_EXTENT
+                || (data->type != 0 && data->extentSize > MAX_COMPRESSED_EXTENT)))
+            throw FsDamagedException("Compressed extent is larger than allowed.");
+    } while(nextExtent());
+
+    int fd = open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0) return false;
+
+    //Extents are streamed through one buffer, adjacent reads are merged
+    //when the batch is submitted. Segments map buffer ranges to file offsets.
+    vector<char> buffer(STREAM_BUFFER_SIZE);
+    vector<ReadRequest> requests;
+    vector<pair<uint64_t, uint64_t>> segments; //File offset and length.
+    uint64_t filled(0);
+    bool success(true);
+    uint32_t sectorSize = btrPool->primarySupblk->sectorSize;
+    //Compressed extents are decoded by worker threads while following ones are read.
+    deque<future<bool>> decoding;
+    auto waitDecoding = [&](size_t maxPending) {
+        while(decoding.size() > maxPending) {
+            success = decoding.front().get() && success;
+            decoding.pop_front();
         }
-        else {
-            char* dataArr;
-            if(unreadSize > data->numOfBytes) {
-                dataArr = new char[data->numOfBytes]();
-                btrPool->readData(dataArr, data->logicalAddress, data->numOfBytes);
-                ofs.write(dataArr, data->numOfBytes);
-                unreadSize -= data->numOfBytes;
-                delete [] dataArr;
+    };
+    auto flush = [&]() {
+        btrPool->readDataBatch(requests);
+        uint64_t bufPos(0);
+        for(const auto &seg : segments) {
+            success = success && writeAll(fd, buffer.data() + bufPos, seg.second, seg.first);
+            bufPos += seg.second;
+        }
+        requests.clear();
+        segments.clear();
+        filled = 0;
+    };
+
+    try {
+        for(bool found = firstExtent(); found; found = nextExtent()) {
+            ItemPtr extent = cursor.getItem();
+            const ExtentData* data = static_cast<const ExtentData*>(extent.get());
+            uint64_t fileOffset = extent->itemHead->key.offset;
+            if(fileOffset >= fileSize)
+                continue;
+
+            if(data->type == 0) { //Is inline file.
+                uint64_t length = min(data->decodedSize, fileSize - fileOffset);
+                if(data->compression != COMPRESS_NONE) {
+                    vector<char> compressed(extent->itemHead->getDataSize() - ExtentData::PART_ONE_SIZE);
+                    btrPool->imgSource->read(data->dataAddress, compressed.data(), compressed.size());
+                    success = decodeExtent(fd, data->compression, move(compressed),
+                            data->decodedSize, 0, length, fileOffset, sectorSize) && success;
+                    continue;
+                }
+                vector<char> dataArr(length);
+                btrPool->imgSource->read(data->dataAddress, dataArr.data(), length);
+                success = success && writeAll(fd, dataArr.data(), length, fileOffset);
+                continue;
             }
-            else {
-                dataArr = new char[unreadSize]();
-                btrPool->readData(dataArr, data->logicalAddress, unreadSize);
-                ofs.write(dataArr, unreadSize);
-                unreadSize = 0;
-                delete [] dataArr;
+            //Holes and preallocated extents read as zeros, they are left
+            //unwritten so the output stays sparse.
+            if(data->logicalAddress == 0 || data->type == 2)
+                continue;
+
+            if(data->compression != COMPRESS_NONE) {
+                //Compressed extents are always read whole.
+                vector<char> compressed(data->extentSize);
+                btrPool->readData(compressed.data(), data->logicalAddress, data->extentSize);
+                waitDecoding(MAX_DECODE_TASKS - 1);
+                decoding.push_back(async(launch::async, decodeExtent, fd, data->compression,
+                            move(compressed), data->decodedSize, data->extentOffset,
+                            min(data->numOfBytes, fileSize - fileOffset), fileOffset, sectorSize));
+                continue;
+            }
+
+            uint64_t extentBytes = min(data->numOfBytes, fileSize - fileOffset);
+            uint64_t extentAddr = data->logicalAddress + data->extentOffset;
+            btrPool->adviseData(extentAddr, extentBytes, AccessHint::SEQUENTIAL);
+
+            uint64_t pos(0);
+            while(pos < extentBytes) {
+                if(filled == buffer.size() || requests.size() == btrPool->getQueueDepth())
+                    flush();
+                uint64_t length = min(extentBytes - pos, buffer.size() - filled);
+                requests.push_back(ReadRequest{extentAddr + pos, buffer.data() + filled, length});
+                if(!segments.empty() && segments.back().first + segments.back().second
+                        == fileOffset + pos)
+                    segments.back().second += length;
+                else
+                    segments.push_back(make_pair(fileOffset + pos, length));
+                filled += length;
+                pos += length;
             }
-            ofs.close();
         }
+        flush();
+        waitDecoding(0);
+    } catch(...) {
+        for(auto &task : decoding)
+            task.wait();
+        close(fd);
+        throw;
     }
-    if(unreadSize != 0) {
-        throw FsDamagedException("File extents missing. Written file is incomplete.");
-    }
-    return true;
+
+    //Gaps between extents and after the last one are holes.
+    success = success && ftruncate(fd, fileSize) == 0;
+    close(fd);
+    return success;
 }
 
 
@@ -328,25 +834,27 @@ const bool FilesystemTree::readFile(uint64_t id)
 //! 
 const bool FilesystemTree::showInodeInfo(uint64_t id, std::ostream& os)
 {
-    const BtrfsItem* foundItem;
-    if(!btrPool->treeSearchById(fileTreeRoot, id,
-            [&foundItem](const LeafNode* leaf, uint64_t targetId)
-            { return searchForItem(leaf, targetId, ItemType::INODE_ITEM, foundItem); }))
+    TreeCursor cursor(btrPool, fileTreeRoot.get());
+    ItemBundle bundle;
+    bundle.load(cursor, id, {ItemType::INODE_ITEM, ItemType::INODE_REF});
+
+    ItemPtr inodeItem = bundle.getFirst(ItemType::INODE_ITEM);
+    if(inodeItem == nullptr)
         return false;
-    const InodeItem* inode = static_cast<const InodeItem*>(foundItem);
+    const InodeItem* inode = static_cast<const InodeItem*>(inodeItem.get());
     uint64_t size = inode->getSize();
         
-    if(!btrPool->treeSearchById(fileTreeRoot, id,
-            [&foundItem](const LeafNode* leaf, uint64_t targetId)
-            { return searchForItem(leaf, targetId, ItemType::INODE_REF, foundItem); }))
+    ItemPtr refItem = bundle.getFirst(ItemType::INODE_REF);
+    if(refItem == nullptr)
         return false;
-    const InodeRef* inodeRef = static_cast<const InodeRef*>(foundItem);
+    const InodeRef* inodeRef = static_cast<const InodeRef*>(refItem.get());
     string name = inodeRef->getDirName();
 
     os << dec;
     os << "Inode number: " << id << endl;
     os << "Size: " << humanSize(size) << endl;
     os << "Name: " << name << endl;
+    os << "Path: " << btrPool->pathResolver.getPath(this, id) << endl;
 
     os << "\nDirectory Entry Times(local);" << endl;
     os << inode->printTime() << endl;
@@ -354,5 +862,86 @@ const bool FilesystemTree::showInodeInfo(uint64_t id, std::ostream& os)
     return true;
 }
 
+//! Find the entry with given name in a directory.
+//!
+//! The dir item is found with one seek, its key offset is the hash of the name.
+//! Names with the same hash share one dir item, of which only the first entry
+//! is decoded, so the index of the directory is scanned in that case.
+//!
+//! \param cursor Cursor of the filesystem tree.
+//! \param reader Reader of the filesystem tree.
+//! \param dirId Inode number of the directory.
+//! \param name Name of the entry.
+//!
+//! \return The entry, empty if not found.
+//!
+static DirReader::EntryPtr findDirEntry(TreeCursor &cursor, DirReader &reader,
+        uint64_t dirId, const string &name)
+{
+    uint64_t hash = nameHash(name);
+    if(!cursor.seek(BtrfsKey(dirId, ItemType::DIR_ITEM, hash)) || cursor.getObjId() != dirId
+            || cursor.getItemType() != ItemType::DIR_ITEM || cursor.getKey().offset != hash)
+        return nullptr;
+
+    DirReader::EntryPtr entry = static_pointer_cast<const DirItem>(cursor.getItem());
+    if(entry->getDirName() == name)
+        return entry;
+
+    vector<DirReader::EntryPtr> batch;
+    if(reader.open(dirId)) {
+        while(reader.read(batch)) {
+            for(auto &child : batch) {
+                if(child->getDirName() == name)
+                    return child;
+            }
+        }
+    }
+    return nullptr;
+}
+
+
+//! Find the inode a path points to.
+//!
+//! Each name in the path is looked up by its hash. The path starts from
+//! the root directory of this tree, entries of other subvolumes are not followed.
+//!
+//! \param path Path of the file, names are separated by '/'.
+//! \param inodeNum Receives inode number of the file.
+//!
+//! \return True if the path is found.
+//!
+const bool FilesystemTree::resolvePath(const std::string &path, uint64_t &inodeNum)
+{
+    TreeCursor cursor(btrPool, fileTreeRoot.get());
+    DirReader reader(btrPool, fileTreeRoot.get());
+    uint64_t current(rootDirId);
+    bool isDir(true);
+
+    for(auto &name : strSplit(path, "/")) {
+        if(name == ".")
+            continue;
+        if(!isDir)
+            return false;
+
+        if(name == "..") {
+            //Offset of the inode ref is the parent directory.
+            if(!cursor.seek(BtrfsKey(current, ItemType::INODE_REF, 0)) || cursor.getObjId() != current
+                    || cursor.getItemType() != ItemType::INODE_REF)
+                return false;
+            current = cursor.getKey().offset;
+            continue;
+        }
+
+        DirReader::EntryPtr entry = findDirEntry(cursor, reader, current, name);
+        if(entry == nullptr || entry->getTargetType() != ItemType::INODE_ITEM)
+            return false;
+        current = entry->getTargetInode();
+        isDir = entry->type == DirItemType::DIRECTORY;
+    }
+
+    inodeNum = current;
+    return true;
+}
+
 }
 
@@ -13,7 +13,8 @@
 #include <functional>
 #include <tsk/libtsk.h>
 #include "Basics/Basics.h"
-#include "DirContent.h"
+#include "BtrfsNode.h"
+#include "DirTable.h"
 
 namespace btrForensics {
     class BtrfsPool;
@@ -21,8 +22,9 @@ namespace btrForensics {
     //! Analyze the file system tree in btrfs.
     class FilesystemTree {
     public:
-        const BtrfsNode *fileTreeRoot; //!< Root node of the filesystem tree.
+        NodePtr fileTreeRoot; //!< Root node of the filesystem tree.
         uint64_t rootDirId; //!< Inode number of root directory.
+        uint64_t fsId; //!< Root item id of this tree, which is the subvolume id.
 
     private:
         BtrfsPool* btrPool;
@@ -33,14 +35,26 @@ namespace btrForensics {
 
         void listDirItems(std::ostream& os);
         void listDirItemsById(uint64_t id, bool dirFlag, bool fileFlag,
-            bool recursive, int level, std::ostream& os);
-
-        DirContent* getDirContent(uint64_t id);
+            bool recursive, int level, std::ostream& os, bool fullPath = false);
+        void listDirItemsBulk(uint64_t id, bool dirFlag, bool fileFlag,
+            std::ostream& os, bool fullPath = false);
+        void listDirItemsParallel(uint64_t id, bool dirFlag, bool fileFlag,
+            std::ostream& os, bool fullPath = false);
 
         const void explorFiles(std::ostream& os, std::istream& is);
         
         const bool readFile(uint64_t id);
         const bool showInodeInfo(uint64_t id, std::ostream& os);
+        const bool resolvePath(const std::string &path, uint64_t &inodeNum);
+
+        static const uint64_t STREAM_BUFFER_SIZE = 8 * 1024 * 1024; //!< Buffer size of file extraction.
+        static const uint64_t MAX_COMPRESSED_EXTENT = 128 * 1024; //!< Largest compressed extent in btrfs.
+        static const unsigned MAX_DECODE_TASKS = 4; //!< Compressed extents decoded at once.
+        static const uint64_t MAX_LISTING_BUFFER = 16 * 1024 * 1024; //!< Parallel listing output held ahead of printing.
+
+    private:
+        static void printDirEntry(std::ostream& os, int level, DirItemType type,
+            uint64_t inodeNum, const std::string *prefix, const std::string &name);
     };
 }
 
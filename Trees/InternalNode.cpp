@@ -8,29 +8,30 @@
 
 namespace btrForensics{
 
-//! Constructor of btrfs leaf node.
+//! Constructor of btrfs internal node.
+//!
+//! Key pointers are parsed from a buffer holding the whole node,
+//! so no further image reads are needed.
 //!
-//! \param img Image file.
-//! \param imgOffset Offset to the partition.
 //! \param header Pointer to header of a node.
 //! \param endian The endianess of the array.
-//! \param startOffset Offset of the node, right after header.
+//! \param nodeArr Byte array storing the whole node, header included.
+//! \param nodeSize Size of the node in bytes.
 //!
-InternalNode::InternalNode(TSK_IMG_INFO *img, const BtrfsHeader *header, 
-        TSK_ENDIAN_ENUM endian, uint64_t startOffset)
+InternalNode::InternalNode(const BtrfsHeader *header, TSK_ENDIAN_ENUM endian,
+        uint8_t nodeArr[], uint32_t nodeSize)
     :BtrfsNode(header)
 {
-    char *diskArr;
+    uint8_t *ptrArr = nodeArr + BtrfsHeader::SIZE_OF_HEADER;
     uint64_t itemOffset(0);
     uint32_t itemNum = header -> getNumOfItems();
 
-    for(uint32_t i=0; i<itemNum; ++i){
-        diskArr = new char[KeyPtr::SIZE_OF_KEY_PTR]();
-        tsk_img_read(img, startOffset + itemOffset,
-                diskArr, KeyPtr::SIZE_OF_KEY_PTR);
+    if((uint64_t)itemNum * KeyPtr::SIZE_OF_KEY_PTR
+            > nodeSize - BtrfsHeader::SIZE_OF_HEADER)
+        throw FsDamagedException("Internal node item number exceeds node size.");
 
-        keyPointers.push_back(new KeyPtr(endian, (uint8_t*)diskArr));
-        delete [] diskArr;
+    for(uint32_t i=0; i<itemNum; ++i){
+        keyPointers.push_back(new KeyPtr(endian, ptrArr + itemOffset));
 
         itemOffset += KeyPtr::SIZE_OF_KEY_PTR;
     }
@@ -45,6 +46,39 @@ InternalNode::~InternalNode()
 }
 
 
+//! Find the child whose subtree may contain the key, using binary search.
+//!
+//! \param key Key to search for.
+//!
+//! \return Index of the last key pointer not greater than the key,
+//!         0 if all key pointers are greater.
+//!
+size_t InternalNode::findChild(const BtrfsKey &key) const
+{
+    size_t low(0), high(keyPointers.size());
+    while(low < high) {
+        size_t mid = low + (high - low) / 2;
+        if(key < keyPointers[mid]->key)
+            high = mid;
+        else
+            low = mid + 1;
+    }
+    return low == 0 ? 0 : low - 1;
+}
+
+
+//! Return bytes of memory held by the node.
+//!
+//! \return Size of the node with its key pointers.
+//!
+uint64_t InternalNode::getFootprint() const
+{
+    return sizeof(InternalNode) + sizeof(BtrfsHeader)
+        + keyPointers.capacity() * sizeof(KeyPtr*)
+        + keyPointers.size() * sizeof(KeyPtr);
+}
+
+
 //! Print info about this node.
 const std::string InternalNode::info() const
 {
@@ -7,6 +7,7 @@
 #define INTERNAL_NODE_H
 
 #include <vector>
+#include <cstddef>
 #include <tsk/libtsk.h>
 #include "BtrfsNode.h"
 
@@ -20,10 +21,13 @@ namespace btrForensics{
         vector<KeyPtr*> keyPointers; //!< Key pointers to other nodes.
 
     public:
-        InternalNode(TSK_IMG_INFO*, const BtrfsHeader*, TSK_ENDIAN_ENUM, uint64_t);
+        InternalNode(const BtrfsHeader*, TSK_ENDIAN_ENUM, uint8_t[], uint32_t);
         ~InternalNode();
 
+        size_t findChild(const BtrfsKey &key) const;
+
         const std::string info() const override;
+        uint64_t getFootprint() const override;
     };
 
 }
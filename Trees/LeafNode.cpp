@@ -4,92 +4,192 @@
 //! Implementation of class LeafNode.
 
 #include <sstream>
+#include <algorithm>
+#include <cstddef>
 #include "LeafNode.h"
 
 namespace btrForensics{
 
 //! Constructor of btrfs leaf node.
 //!
-//! \param img Image file.
+//! Item heads are decoded from a buffer holding the whole node, item
+//! data is copied and decoded on demand, so no further image reads are needed.
+//!
 //! \param header Pointer to header of a node.
-//! \param endian The endianess of the array.
-//! \param startOffset Offset of the node, right after header.
+//! \param end The endianess of the array.
+//! \param nodeArr Byte array storing the whole node, header included.
+//! \param nodeSize Size of the node in bytes.
+//! \param physicalAddr Physical address of the node.
 //!
-LeafNode::LeafNode(TSK_IMG_INFO *img, const BtrfsHeader *header, 
-        TSK_ENDIAN_ENUM endian, uint64_t startOffset)
-    :BtrfsNode(header)
+LeafNode::LeafNode(const BtrfsHeader *header, TSK_ENDIAN_ENUM end,
+        uint8_t nodeArr[], uint32_t nodeSize, uint64_t physicalAddr)
+    :BtrfsNode(header), endian(end),
+     itemAreaAddr(physicalAddr + BtrfsHeader::SIZE_OF_HEADER),
+     itemArea(nodeArr + BtrfsHeader::SIZE_OF_HEADER, nodeArr + nodeSize),
+     items(nullptr)
 {
-    char *diskArr;
+    uint64_t areaSize = itemArea.size();
     uint64_t itemOffset(0);
     uint32_t itemNum = header -> getNumOfItems();
 
-    for(uint32_t i=0; i<itemNum; ++i){
-        diskArr = new char[ItemHead::SIZE_OF_ITEM_HEAD]();
-        tsk_img_read(img, startOffset + itemOffset,
-                diskArr, ItemHead::SIZE_OF_ITEM_HEAD);
-
-        ItemHead *itemHead = new ItemHead(endian, (uint8_t*)diskArr,
-                                    startOffset, itemOffset);
-
-        BtrfsItem *newItem = nullptr;
-        char *itmArr = new char[itemHead->getDataSize()]();
-        uint64_t dataOffset = startOffset + itemHead->getDataOffset();
-        tsk_img_read(img, dataOffset, itmArr, itemHead->getDataSize());
-
-        switch(itemHead->key.itemType){
-            case ItemType::INODE_ITEM:
-                newItem = new InodeItem(itemHead, TSK_LIT_ENDIAN, (uint8_t*)itmArr);
-                break;
-            case ItemType::INODE_REF:
-                newItem = new InodeRef(itemHead, TSK_LIT_ENDIAN, (uint8_t*)itmArr);
-                break;
-            case ItemType::DIR_ITEM: //Both types use the same structure.
-            case ItemType::DIR_INDEX:
-                newItem = new DirItem(itemHead, TSK_LIT_ENDIAN, (uint8_t*)itmArr);
-                break;
-            case ItemType::ROOT_ITEM:
-                newItem = new RootItem(itemHead, TSK_LIT_ENDIAN, (uint8_t*)itmArr);
-                break;
-            case ItemType::ROOT_REF: //Both types use the same structure.
-            case ItemType::ROOT_BACKREF:
-                newItem = new RootRef(itemHead, TSK_LIT_ENDIAN, (uint8_t*)itmArr);
-                break;
-            case ItemType::CHUNK_ITEM:
-                newItem = new ChunkItem(itemHead, TSK_LIT_ENDIAN, (uint8_t*)itmArr);
-                break;
-            case ItemType::EXTENT_DATA:
-                newItem = new ExtentData(itemHead, TSK_LIT_ENDIAN, (uint8_t*)itmArr, dataOffset);
-                break;
-            case ItemType::BLOCK_GROUP_ITEM:
-                newItem = new BlockGroupItem(itemHead, TSK_LIT_ENDIAN, (uint8_t*)itmArr);
-                break;
-            case ItemType::EXTENT_ITEM:
-                newItem = new ExtentItem(itemHead, TSK_LIT_ENDIAN, (uint8_t*)itmArr);
-                break;
-            case ItemType::DEV_ITEM:
-                newItem = new DevItem(itemHead, TSK_LIT_ENDIAN, (uint8_t*)itmArr);
-                break;
-            default:
-                newItem = new UnknownItem(itemHead);
-        }
+    if((uint64_t)itemNum * ItemHead::SIZE_OF_ITEM_HEAD > areaSize)
+        throw FsDamagedException("Leaf node item number exceeds node size.");
 
-        if(newItem != nullptr){
-            itemList.push_back(newItem);
-        }
+    itemHeads.reserve(itemNum);
+    keyObjIds.reserve(itemNum);
+    keyTypes.reserve(itemNum);
+    keyOffsets.reserve(itemNum);
+    for(uint32_t i=0; i<itemNum; ++i){
+        itemHeads.emplace_back(endian, itemArea.data() + itemOffset,
+                                    itemAreaAddr, itemOffset);
 
-        delete [] diskArr;
-        delete [] itmArr;
+        const ItemHead &itemHead = itemHeads.back();
+        if((uint64_t)itemHead.getDataOffset() + itemHead.getDataSize() > areaSize)
+            throw FsDamagedException("Leaf node item data exceeds node size.");
 
+        keyObjIds.push_back(itemHead.key.objId);
+        keyTypes.push_back(itemHead.key.itemType);
+        keyOffsets.push_back(itemHead.key.offset);
         itemOffset += ItemHead::SIZE_OF_ITEM_HEAD;
     }
+
+    items = new std::atomic<const BtrfsItem*>[itemNum]();
 }
 
 
-//! Destructor
+//! Destructor. Items are destroyed in place, the arena frees their memory.
 LeafNode::~LeafNode()
 {
-    for(auto item : itemList)
-        delete item;
+    for(uint32_t i=0; i<getNumOfItems(); ++i) {
+        const BtrfsItem *item = items[i].load();
+        if(item != nullptr)
+            item->~BtrfsItem();
+    }
+    delete [] items;
+}
+
+
+//! Get the item at given index, decoding it on first access.
+//!
+//! \param index Index of the item in the node.
+//!
+//! \return The item, owned by the node.
+//!
+const BtrfsItem* LeafNode::getItem(uint32_t index) const
+{
+    const BtrfsItem *item = items[index].load(std::memory_order_acquire);
+    if(item == nullptr) {
+        std::lock_guard<std::mutex> guard(decodeLock);
+        item = items[index].load(std::memory_order_relaxed);
+        if(item == nullptr) {
+            item = decodeItem(index);
+            items[index].store(item, std::memory_order_release);
+        }
+    }
+    return item;
+}
+
+
+//! Find the first item whose key is not less than the given key, using binary search.
+//!
+//! \param key Key to search for.
+//!
+//! \return Index of the item, number of items if all keys are less.
+//!
+uint32_t LeafNode::lowerBound(const BtrfsKey &key) const
+{
+    uint32_t low(0), high(getNumOfItems());
+    while(low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        bool less;
+        if(keyObjIds[mid] != key.objId)
+            less = keyObjIds[mid] < key.objId;
+        else if(keyTypes[mid] != key.itemType)
+            less = keyTypes[mid] < key.itemType;
+        else
+            less = keyOffsets[mid] < key.offset;
+
+        if(less)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+
+//! Decode data of the item at given index.
+const BtrfsItem* LeafNode::decodeItem(uint32_t index) const
+{
+    const ItemHead *itemHead = &itemHeads[index];
+    uint8_t *dataArr = const_cast<uint8_t*>(itemArea.data()) + itemHead->getDataOffset();
+    uint64_t dataOffset = itemAreaAddr + itemHead->getDataOffset();
+
+    switch(itemHead->key.itemType){
+        case ItemType::INODE_ITEM:
+            return itemArena.create<InodeItem>(itemHead, endian, dataArr);
+        case ItemType::INODE_REF:
+            return itemArena.create<InodeRef>(itemHead, endian, dataArr);
+        case ItemType::DIR_ITEM: //Both types use the same structure.
+        case ItemType::DIR_INDEX:
+            return itemArena.create<DirItem>(itemHead, endian, dataArr);
+        case ItemType::ROOT_ITEM:
+            return itemArena.create<RootItem>(itemHead, endian, dataArr);
+        case ItemType::ROOT_REF: //Both types use the same structure.
+        case ItemType::ROOT_BACKREF:
+            return itemArena.create<RootRef>(itemHead, endian, dataArr);
+        case ItemType::CHUNK_ITEM:
+            return itemArena.create<ChunkItem>(itemHead, endian, dataArr);
+        case ItemType::EXTENT_DATA:
+            return itemArena.create<ExtentData>(itemHead, endian, dataArr, dataOffset);
+        case ItemType::BLOCK_GROUP_ITEM:
+            return itemArena.create<BlockGroupItem>(itemHead, endian, dataArr);
+        case ItemType::EXTENT_ITEM:
+            return itemArena.create<ExtentItem>(itemHead, endian, dataArr);
+        case ItemType::DEV_ITEM:
+            return itemArena.create<DevItem>(itemHead, endian, dataArr);
+        case ItemType::UUID_SUBVOL: //Both types use the same structure.
+        case ItemType::UUID_RECEIVED_SUBVOL:
+            return itemArena.create<UuidItem>(itemHead, endian, dataArr);
+        default:
+            return itemArena.create<UnknownItem>(itemHead);
+    }
+}
+
+
+//! Return arena bytes taken by the largest decoded item, alignment included.
+static size_t maxDecodedSize()
+{
+    static const size_t size = std::max({sizeof(InodeItem), sizeof(InodeRef),
+            sizeof(DirItem), sizeof(RootItem), sizeof(RootRef), sizeof(ChunkItem),
+            sizeof(ExtentData), sizeof(BlockGroupItem), sizeof(ExtentItem),
+            sizeof(DevItem), sizeof(UuidItem), sizeof(UnknownItem)})
+        + alignof(std::max_align_t);
+    return size;
+}
+
+
+//! Return bytes of memory held by the node.
+//!
+//! Items are decoded after the node is cached, so the arena is counted
+//! as if all of them were decoded.
+//!
+//! \return Size of the node with its data, key arrays and decoded items.
+//!
+uint64_t LeafNode::getFootprint() const
+{
+    uint64_t itemSize = maxDecodedSize();
+    uint64_t blockSize = std::max(uint64_t(Arena::DEFAULT_BLOCK_SIZE), itemSize);
+    uint64_t perBlock = blockSize / itemSize;
+    uint64_t arenaBytes = (itemHeads.size() + perBlock - 1) / perBlock * blockSize;
+
+    return sizeof(LeafNode) + sizeof(BtrfsHeader) + itemArea.capacity()
+        + itemHeads.capacity() * sizeof(ItemHead)
+        + keyObjIds.capacity() * sizeof(uint64_t)
+        + keyTypes.capacity() * sizeof(ItemType)
+        + keyOffsets.capacity() * sizeof(uint64_t)
+        + itemHeads.size() * sizeof(std::atomic<const BtrfsItem*>)
+        + arenaBytes;
 }
 
 
@@ -102,8 +202,8 @@ const std::string LeafNode::info() const
     oss << "Item list:" << '\n';
     oss << std::string(30, '=') << "\n\n";
 
-    for(auto &item : itemList){
-        oss << *item;
+    for(uint32_t i=0; i<getNumOfItems(); ++i){
+        oss << *getItem(i);
         oss << std::string(30, '=') << "\n\n";
     }
 
@@ -111,4 +211,3 @@ const std::string LeafNode::info() const
 }
 
 }
-
@@ -8,24 +8,62 @@
 
 #include <vector>
 #include <string>
+#include <atomic>
+#include <mutex>
 #include <tsk/libtsk.h>
 #include "Trees.h"
+#include "Utility/Arena.h"
 
 using std::vector;
 
 namespace btrForensics{
     //! Leaf node in B-tree structure.
+    //!
+    //! Item heads are decoded when the node is built. Item data is kept
+    //! as raw bytes and decoded only when an item is asked for.
+    //! Decoded items live in an arena owned by the node. Items may be
+    //! requested from several threads, each one is decoded only once.
+    //! Key fields are also stored as separate arrays, so that scans
+    //! over keys only touch contiguous memory.
     class LeafNode : public BtrfsNode {
-    public:
-        vector<const BtrfsItem*> itemList; //!< Stores items and their data.
+    private:
+        TSK_ENDIAN_ENUM endian; //!< Endianness of the node.
+        uint64_t itemAreaAddr; //!< Physical address of the end of node header.
+        vector<uint8_t> itemArea; //!< Raw bytes following the node header.
+        vector<ItemHead> itemHeads; //!< Heads of all items, in key order.
+        vector<uint64_t> keyObjIds; //!< Object ids of all item keys.
+        vector<ItemType> keyTypes; //!< Item types of all item keys.
+        vector<uint64_t> keyOffsets; //!< Offsets of all item keys.
+        mutable Arena itemArena; //!< Memory of all decoded items.
+        mutable std::mutex decodeLock; //!< Guards decoding and the arena.
+        std::atomic<const BtrfsItem*> *items; //!< Decoded items, nullptr if not decoded yet.
 
     public:
-        LeafNode(TSK_IMG_INFO*, const BtrfsHeader*, TSK_ENDIAN_ENUM, uint64_t);
+        LeafNode(const BtrfsHeader*, TSK_ENDIAN_ENUM, uint8_t[], uint32_t, uint64_t);
         ~LeafNode();
 
+        //! Return number of items in the node.
+        uint32_t getNumOfItems() const { return itemHeads.size(); }
+        //! Return head of the item at given index, without decoding the item.
+        const ItemHead& getItemHead(uint32_t index) const { return itemHeads[index]; }
+        //! Return key of the item at given index, without decoding the item.
+        const BtrfsKey& getKey(uint32_t index) const { return itemHeads[index].key; }
+        //! Return object id in key of the item at given index.
+        uint64_t getObjId(uint32_t index) const { return keyObjIds[index]; }
+        //! Return item type in key of the item at given index.
+        ItemType getItemType(uint32_t index) const { return keyTypes[index]; }
+        //! Return offset in key of the item at given index.
+        uint64_t getKeyOffset(uint32_t index) const { return keyOffsets[index]; }
+
+        const BtrfsItem* getItem(uint32_t index) const;
+        uint32_t lowerBound(const BtrfsKey &key) const;
+
         const std::string info() const override;
+        uint64_t getFootprint() const override;
+
+    private:
+        const BtrfsItem* decodeItem(uint32_t index) const;
     };
 }
 
 #endif
-
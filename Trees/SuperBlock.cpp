@@ -17,8 +17,7 @@ namespace btrForensics{
 //! \param arr Byte array storing super block data.
 //! 
 SuperBlock::SuperBlock(TSK_ENDIAN_ENUM endian, uint8_t arr[])
-    :fsUUID(endian, arr + 0x20), devItemData(endian, arr + 0xc9),
-     chunkKey(endian, arr + 0x32b), chunkData(endian, arr + 0x33c)
+    :fsUUID(endian, arr + 0x20), devItemData(endian, arr + 0xc9)
 {
     int arIndex(0);
     for(int i=0; i<0x20; i++){
@@ -106,6 +105,53 @@ SuperBlock::SuperBlock(TSK_ENDIAN_ENUM endian, uint8_t arr[])
     for(int i=0; i<LABEL_SIZE; i++){
         label[i] = arr[arIndex++];
     }
+
+    readSysChunks(endian, arr);
+}
+
+
+//! Destructor
+SuperBlock::~SuperBlock()
+{
+    for(auto &chunk : sysChunks)
+        delete chunk.second;
+}
+
+
+//! Read all system chunks stored in sys_chunk_array.
+//!
+//! \param endian The endianess of the array.
+//! \param arr Byte array storing super block data.
+//!
+void SuperBlock::readSysChunks(TSK_ENDIAN_ENUM endian, uint8_t arr[])
+{
+    uint32_t arrSize = sysChunkArrSize;
+    if(arrSize > SYS_CHUNK_ARR_SIZE)
+        arrSize = SYS_CHUNK_ARR_SIZE;
+
+    uint32_t pos(0);
+    const uint32_t headSize = BtrfsKey::SIZE_OF_KEY + ChunkData::SIZE_OF_CHUNK_DATA;
+    while(pos + headSize <= arrSize) {
+        uint8_t *entry = arr + SYS_CHUNK_ARR_ADDR + pos;
+        BtrfsKey key(endian, entry);
+
+        //Number of stripes is stored at 0x2c of chunk item data.
+        uint16_t numStripe = read16Bit(endian, entry + BtrfsKey::SIZE_OF_KEY + 0x2c);
+        uint32_t entrySize = headSize + numStripe * Stripe::SIZE_OF_STRIPE;
+        if(key.itemType != ItemType::CHUNK_ITEM || numStripe == 0
+                || pos + entrySize > arrSize) {
+            for(auto &chunk : sysChunks)
+                delete chunk.second;
+            throw FsDamagedException("Superblock system chunk array damaged.");
+        }
+
+        sysChunks.push_back(std::make_pair(key,
+                    new ChunkData(endian, entry + BtrfsKey::SIZE_OF_KEY)));
+        pos += entrySize;
+    }
+
+    if(sysChunks.size() == 0)
+        throw FsDamagedException("Superblock system chunk array damaged. No chunk found.");
 }
 
 
@@ -116,7 +162,6 @@ SuperBlock::SuperBlock(TSK_ENDIAN_ENUM endian, uint8_t arr[])
 const uint64_t SuperBlock::getChunkPhyAddr() const
 {
     return 0;
-    //return getChunkAddr(chunkTrRootAddr, &chunkKey, &chunkData);
 }
 
 
@@ -188,8 +233,13 @@ std::ostream &operator<<(std::ostream &os, SuperBlock &supb)
         supb.leafSize << "\t" << supb.stripeSize << "\n\n";
 
     os << "System chunk array size: " << supb.sysChunkArrSize << '\n';
-    os << "Chunk item data:" << "\n";
-    os << supb.chunkData.dataInfo() <<'\n';
+    for(const auto &chunk : supb.sysChunks) {
+        os << "Chunk item data:" << "\n";
+        os << "Logical address: 0x" << std::hex << std::uppercase;
+        os.width(16);
+        os << chunk.first.offset << std::dec << '\n';
+        os << chunk.second->dataInfo() <<'\n';
+    }
 
     os << std::endl;
     return os;
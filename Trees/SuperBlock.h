@@ -9,6 +9,8 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <utility>
 #include "Utility/Utility.h"
 #include "Basics/Basics.h"
 
@@ -60,12 +62,12 @@ namespace btrForensics{
         const DevData devItemData; //0xc9
         uint8_t label[LABEL_SIZE];
 
-        const BtrfsKey chunkKey;
-        const ChunkData chunkData;
+        //! System chunks in sys_chunk_array, key offset is chunk logical address.
+        std::vector<std::pair<BtrfsKey, const ChunkData*>> sysChunks;
 
     public:
         SuperBlock(TSK_ENDIAN_ENUM endian, uint8_t arr[]);
-        ~SuperBlock() = default; //!< Destructor
+        ~SuperBlock();
 
         const uint64_t getChunkPhyAddr() const;
         const uint64_t getRootLogAddr() const;
@@ -76,6 +78,11 @@ namespace btrForensics{
 
         static const int SUPBLK_ADDR = 0x10000;  //!< Address of superblock on disk.
         static const int SUPBLK_SIZE = 0xb2b;  //!< Size of superblock on disk.
+        static const int SYS_CHUNK_ARR_ADDR = 0x32b;  //!< Offset of sys_chunk_array in superblock.
+        static const int SYS_CHUNK_ARR_SIZE = 0x800;  //!< Maximum size of sys_chunk_array.
+
+    private:
+        void readSysChunks(TSK_ENDIAN_ENUM endian, uint8_t arr[]);
 
         friend std::ostream &operator<<(std::ostream &os, SuperBlock &supb);
     };
@@ -8,7 +8,7 @@
 #include "InternalNode.h"
 #include "LeafNode.h"
 
-#include "DirContent.h"
+#include "DirTable.h"
 
 #include "ChunkTree.h"
 #include "FilesystemTree.h"
@@ -0,0 +1,57 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Implementation of class Arena.
+
+#include <cstdint>
+#include "Arena.h"
+
+namespace btrForensics {
+
+//! Constructor of arena. No memory is allocated until first use.
+//!
+//! \param size Size of a regular block.
+//!
+Arena::Arena(size_t size)
+    :blockSize(size), current(nullptr), remaining(0) {}
+
+
+//! Destructor, frees all blocks.
+Arena::~Arena()
+{
+    for(auto block : blocks)
+        ::operator delete(block);
+}
+
+
+//! Allocate memory from the arena.
+//!
+//! \param size Number of bytes needed.
+//! \param align Alignment of the memory, must be a power of two.
+//!
+//! \return Pointer to the allocated memory.
+//!
+void* Arena::allocate(size_t size, size_t align)
+{
+    size_t padding = (align - (reinterpret_cast<uintptr_t>(current) & (align - 1)))
+                        & (align - 1);
+
+    if(current == nullptr || padding + size > remaining) {
+        //Oversized requests get a block of their own.
+        size_t newSize = size + align > blockSize ? size + align : blockSize;
+        blocks.reserve(blocks.size() + 1);
+        char *block = static_cast<char*>(::operator new(newSize));
+        blocks.push_back(block);
+        current = block;
+        remaining = newSize;
+        padding = (align - (reinterpret_cast<uintptr_t>(current) & (align - 1)))
+                        & (align - 1);
+    }
+
+    void *result = current + padding;
+    current += padding + size;
+    remaining -= padding + size;
+    return result;
+}
+
+}
@@ -0,0 +1,48 @@
+//! \file
+//! \author Shujian Yang
+//!
+//! Header file of class Arena.
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace btrForensics {
+
+//! Bump allocator releasing all its memory at once.
+//!
+//! Objects created in an arena are never freed one by one,
+//! their destructors have to be called by the owner if needed.
+class Arena {
+private:
+    std::vector<char*> blocks; //!< All blocks allocated so far.
+    size_t blockSize; //!< Size of a regular block.
+    char *current; //!< Next free byte in the last block.
+    size_t remaining; //!< Free bytes left in the last block.
+
+public:
+    explicit Arena(size_t size = DEFAULT_BLOCK_SIZE);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+    //! Construct an object inside the arena.
+    template<typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    static const size_t DEFAULT_BLOCK_SIZE = 4096; //!< Default size of a block.
+};
+
+}
+
+#endif
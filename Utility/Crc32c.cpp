@@ -0,0 +1,106 @@
+/**
+ * \file
+ * \author Shujian Yang
+ *
+ * File containing crc32c checksum used by btrfs.
+ */
+
+#include <cstring>
+#include "Crc32c.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_SSE42_CRC
+#include <nmmintrin.h>
+#endif
+
+namespace btrForensics {
+
+static const uint32_t CRC32C_POLY = 0x82F63B78; //!< Reversed Castagnoli polynomial.
+
+//! Table of crc32c values of all bytes.
+struct Crc32cTable {
+    uint32_t values[256];
+
+    Crc32cTable() {
+        for(uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for(int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ (crc & 1 ? CRC32C_POLY : 0);
+            values[i] = crc;
+        }
+    }
+};
+
+
+//! Compute crc32c byte by byte with a lookup table.
+static uint32_t crc32cSoftware(uint32_t crc, const uint8_t *data, size_t size)
+{
+    static const Crc32cTable table;
+    while(size-- > 0)
+        crc = table.values[(crc ^ *data++) & 0xff] ^ (crc >> 8);
+    return crc;
+}
+
+
+#ifdef HAVE_SSE42_CRC
+//! Compute crc32c with the crc32 instruction of SSE4.2.
+__attribute__((target("sse4.2")))
+static uint32_t crc32cHardware(uint32_t crc, const uint8_t *data, size_t size)
+{
+#ifdef __x86_64__
+    uint64_t crc64 = crc;
+    for(; size >= 8; size -= 8, data += 8) {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = (uint32_t)crc64;
+#endif
+    while(size-- > 0)
+        crc = _mm_crc32_u8(crc, *data++);
+    return crc;
+}
+
+
+//! Check once whether the processor supports SSE4.2.
+static bool hardwareSupported()
+{
+    static const bool supported = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2") != 0;
+    }();
+    return supported;
+}
+#endif
+
+
+//! Compute crc32c of a buffer.
+//!
+//! As in btrfs, the value is neither inverted before nor after, so the
+//! seed is passed as it is and the result can be chained.
+//!
+//! \param crc Initial value.
+//! \param data Data to be checked.
+//! \param size Size of data.
+//!
+uint32_t crc32c(uint32_t crc, const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t*>(data);
+#ifdef HAVE_SSE42_CRC
+    if(hardwareSupported())
+        return crc32cHardware(crc, bytes, size);
+#endif
+    return crc32cSoftware(crc, bytes, size);
+}
+
+
+//! Compute hash of a name, stored in key offset of its dir item.
+//!
+//! \param name Name of a directory entry.
+//!
+uint32_t nameHash(const std::string &name)
+{
+    return crc32c(NAME_HASH_SEED, name.data(), name.size());
+}
+
+}
@@ -0,0 +1,23 @@
+/**
+ * \file
+ * \author Shujian Yang
+ *
+ * Header file of crc32c checksum.
+ */
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace btrForensics {
+    static const uint32_t NAME_HASH_SEED = ~(uint32_t)1; //!< Seed of name hashes in dir item keys.
+
+    uint32_t crc32c(uint32_t crc, const void *data, size_t size);
+
+    uint32_t nameHash(const std::string &name);
+}
+
+#endif
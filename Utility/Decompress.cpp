@@ -0,0 +1,193 @@
+/**
+ * \file
+ * \author Shujian Yang
+ *
+ * File containing decompression of btrfs extents.
+ */
+
+#include "Decompress.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_LZO
+#include <lzo/lzo1x.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace btrForensics {
+
+//! Check whether a compression type can be decoded by this build.
+//!
+//! \param compression Compression type of an extent.
+//!
+bool decompressSupported(uint8_t compression)
+{
+    switch(compression) {
+        case COMPRESS_NONE:
+            return true;
+#ifdef HAVE_ZLIB
+        case COMPRESS_ZLIB:
+            return true;
+#endif
+#ifdef HAVE_LZO
+        case COMPRESS_LZO:
+            return lzo_init() == LZO_E_OK;
+#endif
+#ifdef HAVE_ZSTD
+        case COMPRESS_ZSTD:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+
+#ifdef HAVE_ZLIB
+//! Inflate a zlib stream, stopping when the output buffer is full.
+static bool inflateZlib(const char *src, size_t srcSize,
+        char *dst, size_t dstSize, size_t &decoded)
+{
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    strm.next_in = (Bytef*)src;
+    strm.avail_in = srcSize;
+    if(inflateInit(&strm) != Z_OK)
+        return false;
+
+    strm.next_out = (Bytef*)dst;
+    strm.avail_out = dstSize;
+    int ret = inflate(&strm, Z_FINISH);
+    decoded = dstSize - strm.avail_out;
+    inflateEnd(&strm);
+
+    //Output may end before the stream when only part of an extent is wanted.
+    return ret == Z_STREAM_END || (ret == Z_BUF_ERROR && strm.avail_out == 0);
+}
+#endif
+
+
+#ifdef HAVE_LZO
+//! Read a 32-bit little endian length of LZO framing.
+static uint32_t readLzoLength(const char *arr)
+{
+    const uint8_t *p = (const uint8_t*)arr;
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+
+//! Decompress btrfs LZO framing.
+//!
+//! The extent starts with its total length, followed by segments each
+//! with its own length. A segment length never crosses a sector
+//! boundary, the rest of a sector too short to hold one is zero padded.
+//!
+static bool inflateLzo(const char *src, size_t srcSize,
+        char *dst, size_t dstSize, size_t sectorSize, size_t &decoded)
+{
+    const size_t LZO_LEN = 4;
+    decoded = 0;
+    if(srcSize < LZO_LEN || sectorSize < LZO_LEN)
+        return false;
+
+    size_t totalLen = readLzoLength(src);
+    if(totalLen > srcSize)
+        return false;
+
+    size_t pos(LZO_LEN);
+    while(pos < totalLen && decoded < dstSize) {
+        if(pos + LZO_LEN > totalLen)
+            return false;
+        size_t segLen = readLzoLength(src + pos);
+        pos += LZO_LEN;
+        if(segLen > totalLen - pos)
+            return false;
+
+        lzo_uint outLen = dstSize - decoded;
+        int ret = lzo1x_decompress_safe((const unsigned char*)src + pos, segLen,
+                (unsigned char*)dst + decoded, &outLen, nullptr);
+        //Output overrun only means the buffer is full.
+        if(ret != LZO_E_OK && ret != LZO_E_OUTPUT_OVERRUN)
+            return false;
+        decoded += outLen;
+        pos += segLen;
+
+        size_t sectorLeft = (sectorSize - pos % sectorSize) % sectorSize;
+        if(sectorLeft < LZO_LEN)
+            pos += sectorLeft;
+    }
+    return true;
+}
+#endif
+
+
+#ifdef HAVE_ZSTD
+//! Decompress a zstd frame, stopping when the output buffer is full.
+static bool inflateZstd(const char *src, size_t srcSize,
+        char *dst, size_t dstSize, size_t &decoded)
+{
+    ZSTD_DStream *stream = ZSTD_createDStream();
+    if(stream == nullptr)
+        return false;
+    ZSTD_initDStream(stream);
+
+    ZSTD_inBuffer input = { src, srcSize, 0 };
+    ZSTD_outBuffer output = { dst, dstSize, 0 };
+    bool success(true);
+    while(output.pos < output.size) {
+        size_t ret = ZSTD_decompressStream(stream, &output, &input);
+        if(ZSTD_isError(ret)) {
+            success = false;
+            break;
+        }
+        //Frame finished, or no more input to make progress with.
+        if(ret == 0 || (input.pos == input.size && output.pos < output.size))
+            break;
+    }
+    decoded = output.pos;
+    ZSTD_freeDStream(stream);
+    return success;
+}
+#endif
+
+
+//! Decompress data of a compressed extent.
+//!
+//! \param compression Compression type of the extent.
+//! \param src Compressed data.
+//! \param srcSize Size of compressed data.
+//! \param[out] dst Buffer receiving decompressed data.
+//! \param dstSize Size of the buffer, decoding stops when it is full.
+//! \param sectorSize Sector size of the filesystem, used by LZO framing.
+//! \param[out] decoded Number of bytes decompressed.
+//!
+//! \return False if data is corrupted or compression type is not supported.
+//!
+bool decompressExtent(uint8_t compression, const char *src, size_t srcSize,
+        char *dst, size_t dstSize, size_t sectorSize, size_t &decoded)
+{
+    decoded = 0;
+    switch(compression) {
+#ifdef HAVE_ZLIB
+        case COMPRESS_ZLIB:
+            return inflateZlib(src, srcSize, dst, dstSize, decoded);
+#endif
+#ifdef HAVE_LZO
+        case COMPRESS_LZO:
+            return inflateLzo(src, srcSize, dst, dstSize, sectorSize, decoded);
+#endif
+#ifdef HAVE_ZSTD
+        case COMPRESS_ZSTD:
+            return inflateZstd(src, srcSize, dst, dstSize, decoded);
+#endif
+        default:
+            return false;
+    }
+}
+
+}
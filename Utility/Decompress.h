@@ -0,0 +1,26 @@
+/**
+ * \file
+ * \author Shujian Yang
+ *
+ * Header file of extent decompression.
+ */
+
+#ifndef DECOMPRESS_H
+#define DECOMPRESS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace btrForensics {
+    static const uint8_t COMPRESS_NONE = 0; //!< Extent not compressed.
+    static const uint8_t COMPRESS_ZLIB = 1; //!< Extent compressed with zlib.
+    static const uint8_t COMPRESS_LZO = 2; //!< Extent compressed with LZO, framed per sector.
+    static const uint8_t COMPRESS_ZSTD = 3; //!< Extent compressed with zstd.
+
+    bool decompressSupported(uint8_t compression);
+
+    bool decompressExtent(uint8_t compression, const char *src, size_t srcSize,
+            char *dst, size_t dstSize, size_t sectorSize, size_t &decoded);
+}
+
+#endif
@@ -56,5 +56,27 @@ string strStrip(string input)
         return "";
 }
 
+
+//! Format a time in local time zone the way asctime does.
+//!
+//! Unlike asctime and localtime, it is safe to call from several threads.
+//! 
+//! \param time The time to format.
+//!
+//! \return Formatted time, ending with a newline.
+//!
+string timeStr(time_t time)
+{
+    struct tm local;
+    char buffer[32]; //asctime_r needs at least 26 bytes.
+#ifdef TSK_WIN32
+    localtime_s(&local, &time);
+    asctime_s(buffer, sizeof(buffer), &local);
+#else
+    localtime_r(&time, &local);
+    asctime_r(&local, buffer);
+#endif
+    return string(buffer);
 }
 
+}
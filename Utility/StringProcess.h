@@ -10,12 +10,15 @@
 
 #include <string>
 #include <vector>
+#include <ctime>
 #include <tsk/libtsk.h>
 
 namespace btrForensics {
     std::vector<std::string> strSplit(std::string, std::string);
 
     std::string strStrip(std::string);
+
+    std::string timeStr(time_t);
 }
 
 #endif
@@ -11,6 +11,9 @@
 #include "ReadInt.h"
 #include "StringProcess.h"
 #include "Uuid.h"
+#include "Decompress.h"
+#include "Arena.h"
+#include "Crc32c.h"
 
 #endif
 
@@ -497,5 +497,41 @@ bool operator!=(const UUID &lhs, const UUID &rhs)
     return !(lhs == rhs);
 }
 
+
+//! Parse a UUID string into bytes.
+//!
+//! Hex digits are taken in the order bytes are stored, as btrfs tools print
+//! them, dashes are ignored.
+//!
+//! \param str The UUID string.
+//! \param arr Array of BYTES_OF_UUID bytes receiving the UUID.
+//!
+//! \return True if the string is a valid UUID.
+//!
+bool UUID::parse(const std::string &str, uint8_t arr[])
+{
+    int digits(0);
+    for(char c : str) {
+        if(c == '-')
+            continue;
+        int value;
+        if(c >= '0' && c <= '9')
+            value = c - '0';
+        else if(c >= 'a' && c <= 'f')
+            value = c - 'a' + 10;
+        else if(c >= 'A' && c <= 'F')
+            value = c - 'A' + 10;
+        else
+            return false;
+        if(digits == BYTES_OF_UUID * 2)
+            return false;
+        if(digits % 2 == 0)
+            arr[digits / 2] = value << 4;
+        else
+            arr[digits / 2] |= value;
+        ++digits;
+    }
+    return digits == BYTES_OF_UUID * 2;
 }
 
+}
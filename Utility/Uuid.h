@@ -65,6 +65,8 @@ public:
 
     UUID& operator=(const UUID& rhs);
 
+    static bool parse(const std::string &str, uint8_t arr[]);
+
     static const int BYTES_OF_UUID = 16; //!< UUID byte length when stored in machine,
     static const int LENGTH_OF_UUID_STRING = 36; //!< String length used to represent a UUID.
 };
@@ -109,13 +109,13 @@ int main(int argc, char *argv[])
             cout << std::string(60, '=') << "\n";
             cout << endl;
             if(answer == "1"){
-                btr.navigateNodes(btr.rootTree, cout, cin);
+                btr.navigateNodes(btr.rootTree.get(), cout, cin);
             }
             else if(answer == "2"){
-                btr.navigateNodes(btr.chunkTree->chunkRoot, cout, cin);
+                btr.navigateNodes(btr.chunkTree->chunkRoot.get(), cout, cin);
             }
             else if(answer == "3"){
-                btr.navigateNodes(btr.fsTreeDefault->fileTreeRoot, cout, cin);
+                btr.navigateNodes(btr.fsTreeDefault->fileTreeRoot.get(), cout, cin);
             }
             else if(answer == "4") {
                 cout << "Listing directory items...\n" << endl;